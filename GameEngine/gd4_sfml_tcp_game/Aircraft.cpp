@@ -52,8 +52,7 @@ Aircraft::Aircraft(AircraftType type, const TextureHolder& textures, const FontH
 	: Entity(Table[static_cast<int>(type)].m_hitpoints)
 	, m_type(type)
 	, m_player_id(player_id)
-	, m_sprite(textures.Get(Table[static_cast<int>(type)].m_texture), Table[static_cast<int>(type)].m_texture_rect)
-	, m_explosion(textures.Get(TextureID::kExplosion))
+	, m_local_bounds(Utility::CentredBounds(Table[static_cast<int>(type)].m_texture_rect))
 	, m_health_display(nullptr)
 	, m_missile_display(nullptr)
 	, m_distance_travelled(0.f)
@@ -68,6 +67,7 @@ Aircraft::Aircraft(AircraftType type, const TextureHolder& textures, const FontH
 	, m_show_explosion(true)
 	, m_spawned_pickup(false)
 	, m_played_explosion_sound(false)
+	, m_random()
 	, m_is_on_ground(true)
 	, m_jump_speed(750.f)
 	, m_gun_world_rotation(0.f)
@@ -82,8 +82,6 @@ Aircraft::Aircraft(AircraftType type, const TextureHolder& textures, const FontH
 	, m_just_landed(false)
 	, m_just_got_hit(false)
 	, m_just_died(false)
-	, m_idle_animation(textures.Get(TextureID::kPlayer1Animations))
-	, m_run_animation(textures.Get(TextureID::kPlayer1Animations))
 	, m_current_animation(nullptr)
 	, m_use_animations(false)
 	, m_facing_right(true)
@@ -91,13 +89,23 @@ Aircraft::Aircraft(AircraftType type, const TextureHolder& textures, const FontH
 	, m_is_emitting_dust(false)
 
 {
-	m_explosion.SetFrameSize(sf::Vector2i(256, 256));
-	m_explosion.SetNumFrames(16);
-	m_explosion.SetDuration(sf::seconds(1));
-	Utility::CentreOrigin(m_sprite);
-	Utility::CentreOrigin(m_explosion);
+	//Visuals are only built when their textures are loaded, a headless World loads none
+	if (textures.Contains(Table[static_cast<int>(type)].m_texture))
+	{
+		m_sprite.emplace(textures.Get(Table[static_cast<int>(type)].m_texture), Table[static_cast<int>(type)].m_texture_rect);
+		Utility::CentreOrigin(*m_sprite);
+	}
 
-	if (m_player_id >= 0)
+	if (textures.Contains(TextureID::kExplosion))
+	{
+		m_explosion.emplace(textures.Get(TextureID::kExplosion));
+		m_explosion->SetFrameSize(sf::Vector2i(256, 256));
+		m_explosion->SetNumFrames(16);
+		m_explosion->SetDuration(sf::seconds(1));
+		Utility::CentreOrigin(*m_explosion);
+	}
+
+	if (m_player_id >= 0 && textures.Contains(TextureID::kParticle))
 	{
 		//Create dust emitter for player and store pointer so we can toggle emission on/off
 		std::unique_ptr<EmitterNode> dust_emitter(new EmitterNode(ParticleType::kDust));
@@ -108,34 +116,39 @@ Aircraft::Aircraft(AircraftType type, const TextureHolder& textures, const FontH
 		m_dust_emitter->SetEmissionRate(15.f);
 
 		AttachChild(std::move(dust_emitter));
+	}
 
+	TextureID anim_texture = (m_player_id == 0) ? TextureID::kPlayer1Animations : TextureID::kPlayer2Animations;
+	if (m_player_id >= 0 && textures.Contains(anim_texture))
+	{
 		m_use_animations = true;
 
-		TextureID anim_texture = (m_player_id == 0) ? TextureID::kPlayer1Animations : TextureID::kPlayer2Animations;
-
-		m_idle_animation.SetTexture(textures.Get(anim_texture));
-		m_idle_animation.SetFrameSize(sf::Vector2i(64, 64));
-		m_idle_animation.SetNumFrames(4);
-		m_idle_animation.SetDuration(sf::seconds(0.5f));
-		m_idle_animation.SetRepeating(true);
-		Utility::CentreOrigin(m_idle_animation);
+		m_idle_animation.emplace(textures.Get(anim_texture));
+		m_idle_animation->SetFrameSize(sf::Vector2i(64, 64));
+		m_idle_animation->SetNumFrames(4);
+		m_idle_animation->SetDuration(sf::seconds(0.5f));
+		m_idle_animation->SetRepeating(true);
+		Utility::CentreOrigin(*m_idle_animation);
 
-		m_run_animation.SetTexture(textures.Get(anim_texture));
-		m_run_animation.SetFrameSize(sf::Vector2i(64, 64));
-		m_run_animation.SetNumFrames(4);
-		m_run_animation.SetDuration(sf::seconds(0.8f));
-		m_run_animation.SetRepeating(true);
-		Utility::CentreOrigin(m_run_animation);
+		m_run_animation.emplace(textures.Get(anim_texture));
+		m_run_animation->SetFrameSize(sf::Vector2i(64, 64));
+		m_run_animation->SetNumFrames(4);
+		m_run_animation->SetDuration(sf::seconds(0.8f));
+		m_run_animation->SetRepeating(true);
+		Utility::CentreOrigin(*m_run_animation);
 
-		m_current_animation = &m_idle_animation;
+		m_current_animation = &*m_idle_animation;
 	}
 
 	if (Table[static_cast<int>(type)].m_has_gun)
 	{
 		const AircraftData& d = Table[static_cast<int>(type)];
 
-		m_gun_sprite = std::make_unique<sf::Sprite>(textures.Get(d.m_gun_texture), d.m_gun_texture_rect);
-		Utility::CentreOrigin(*m_gun_sprite);
+		if (textures.Contains(d.m_gun_texture))
+		{
+			m_gun_sprite = std::make_unique<sf::Sprite>(textures.Get(d.m_gun_texture), d.m_gun_texture_rect);
+			Utility::CentreOrigin(*m_gun_sprite);
+		}
 
 		m_gun_offset = d.m_gun_offset;
 		m_has_gun = true;
@@ -162,12 +175,15 @@ Aircraft::Aircraft(AircraftType type, const TextureHolder& textures, const FontH
 			CreatePickup(node, textures);
 		};
 
-	std::string* health = new std::string("");
-	std::unique_ptr<TextNode> health_display(new TextNode(fonts, *health));
-	m_health_display = health_display.get();
-	AttachChild(std::move(health_display));
+	if (fonts.Contains(Font::kMain))
+	{
+		std::string* health = new std::string("");
+		std::unique_ptr<TextNode> health_display(new TextNode(fonts, *health));
+		m_health_display = health_display.get();
+		AttachChild(std::move(health_display));
+	}
 
-	if (Aircraft::GetCategory() == static_cast<int>(ReceiverCategories::kPlayerAircraft))
+	if (fonts.Contains(Font::kMain) && Aircraft::GetCategory() == static_cast<int>(ReceiverCategories::kPlayerAircraft))
 	{
 		std::string* missile_ammo = new std::string("");
 		std::unique_ptr<TextNode> missile_display(new TextNode(fonts, *missile_ammo));
@@ -289,6 +305,45 @@ bool Aircraft::HasActivePowerUp(PickupType type) const
 	return false;
 }
 
+unsigned int Aircraft::GetActivePowerUpMask() const
+{
+	unsigned int mask = 0;
+	for (const auto& effect : m_active_powerups)
+	{
+		mask |= 1u << static_cast<unsigned int>(effect.type);
+	}
+	return mask;
+}
+
+void Aircraft::SetActivePowerUps(unsigned int mask)
+{
+	//The server decides when an effect ends, so the local timer only needs to outlast the gap between snapshots
+	const sf::Time kReplicaDuration = sf::seconds(60.f);
+
+	for (auto it = m_active_powerups.begin(); it != m_active_powerups.end(); )
+	{
+		if (mask & (1u << static_cast<unsigned int>(it->type)))
+		{
+			it->remaining_duration = kReplicaDuration;
+			++it;
+		}
+		else
+		{
+			RemovePowerUp(it->type);
+			it = m_active_powerups.erase(it);
+		}
+	}
+
+	for (int i = 0; i < static_cast<int>(PickupType::kPickupCount); ++i)
+	{
+		PickupType type = static_cast<PickupType>(i);
+		if ((mask & (1u << i)) && !HasActivePowerUp(type))
+		{
+			ApplyPowerUp(type, kReplicaDuration);
+		}
+	}
+}
+
 float Aircraft::GetDamageMultiplier() const
 {
 	return m_damage_multiplier;
@@ -343,6 +398,9 @@ void Aircraft::RemovePowerUp(PickupType type)
 
 void Aircraft::UpdateTexts()
 {
+	if (!m_health_display)
+		return;
+
 	m_health_display->SetString(std::to_string(GetHitPoints()) + "HP");
 	m_health_display->setPosition({ 0.f, -50.f });
 	m_health_display->setRotation(-getRotation());
@@ -435,7 +493,7 @@ void Aircraft::CreateProjectile(SceneNode& node, ProjectileType type, float x_of
 {
 	std::unique_ptr<Projectile> projectile(new Projectile(type, textures, m_damage_multiplier));
 
-	const sf::Vector2f gun_world_pos = (m_has_gun && m_gun_sprite)
+	const sf::Vector2f gun_world_pos = m_has_gun
 		? (GetWorldPosition() + RotateVectorDeg(m_gun_offset, m_gun_current_world_rotation))
 		: GetWorldPosition();
 
@@ -455,13 +513,16 @@ void Aircraft::CreateProjectile(SceneNode& node, ProjectileType type, float x_of
 	projectile->setPosition(spawn_pos);
 	projectile->SetVelocity(velocity);
 	projectile->setRotation(sf::degrees(firing_angle_deg));
+	projectile->SetShooter(m_player_id);
+	//Swept from the muzzle on its first tick, so a shot fired point blank at a platform can't skip through it
+	projectile->ResetInterpolation();
 
 	node.AttachChild(std::move(projectile));
 }
 
 sf::FloatRect Aircraft::GetBoundingRect() const
 {
-	return GetWorldTransform().transformRect(m_sprite.getGlobalBounds());
+	return GetWorldTransform().transformRect(m_local_bounds);
 }
 
 bool Aircraft::IsMarkedForRemoval() const
@@ -486,16 +547,17 @@ void Aircraft::DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) co
 		{
 			target.draw(*m_current_animation, states);
 		}
-		else
+		else if (m_sprite)
 		{
-			target.draw(m_sprite, states);
+			target.draw(*m_sprite, states);
 		}
 
 		if (m_has_gun && m_gun_sprite)
 		{
 			//Orbit gun around the aircraft center using the smoothed world rotation.
 			const sf::Vector2f rotated_offset = RotateVectorDeg(m_gun_offset, m_gun_current_world_rotation);
-			const sf::Vector2f world_pos = GetWorldPosition() + rotated_offset;
+			//states carries the interpolated world transform, GetWorldPosition would be the latest tick
+			const sf::Vector2f world_pos = states.transform.transformPoint({ 0.f, 0.f }) + rotated_offset;
 
 			m_gun_sprite->setPosition(world_pos);
 			m_gun_sprite->setRotation(sf::degrees(m_gun_current_world_rotation));
@@ -515,7 +577,7 @@ void Aircraft::AttachGun(const TextureHolder& textures, TextureID textureId, con
 
 void Aircraft::AimGunAt(const sf::Vector2f& worldPosition)
 {
-	if (!m_has_gun || !m_gun_sprite)
+	if (!m_has_gun)
 		return;
 
 	//Desired angle in world space
@@ -546,6 +608,17 @@ sf::Vector2f Aircraft::GetGunOffset() const
 	return m_gun_offset;
 }
 
+float Aircraft::GetGunRotation() const
+{
+	return m_gun_current_world_rotation;
+}
+
+void Aircraft::SetGunRotation(float degrees)
+{
+	m_gun_world_rotation = degrees;
+	m_gun_current_world_rotation = degrees;
+}
+
 void Aircraft::UpdateCurrent(sf::Time dt, CommandQueue& commands)
 {
 	if (m_player_id >= 0)
@@ -621,14 +694,14 @@ void Aircraft::UpdateCurrent(sf::Time dt, CommandQueue& commands)
 		}
 
 		//Switch animation based on movement state (idle or running)
-		if (is_moving && m_current_animation != &m_run_animation)
+		if (is_moving && m_current_animation != &*m_run_animation)
 		{
-			m_current_animation = &m_run_animation;
+			m_current_animation = &*m_run_animation;
 			m_current_animation->Restart();
 		}
-		else if (!is_moving && m_current_animation != &m_idle_animation)
+		else if (!is_moving && m_current_animation != &*m_idle_animation)
 		{
-			m_current_animation = &m_idle_animation;
+			m_current_animation = &*m_idle_animation;
 			m_current_animation->Restart();
 		}
 
@@ -643,7 +716,7 @@ void Aircraft::UpdateCurrent(sf::Time dt, CommandQueue& commands)
 
 	UpdateRollAnimation();
 
-	if (m_has_gun && m_gun_sprite)
+	if (m_has_gun)
 	{
 		const float dtSec = dt.asSeconds();
 
@@ -654,8 +727,11 @@ void Aircraft::UpdateCurrent(sf::Time dt, CommandQueue& commands)
 
 		m_gun_current_world_rotation += angleDiff;
 
-		sf::Vector2f currentScale = m_gun_sprite->getScale();
-		m_gun_sprite->setScale({ std::abs(currentScale.x), std::abs(currentScale.y) });
+		if (m_gun_sprite)
+		{
+			sf::Vector2f currentScale = m_gun_sprite->getScale();
+			m_gun_sprite->setScale({ std::abs(currentScale.x), std::abs(currentScale.y) });
+		}
 	}
 
 	//Check if bullets or misiles are fired
@@ -699,7 +775,7 @@ bool Aircraft::IsAllied() const
 
 void Aircraft::CreatePickup(SceneNode& node, const TextureHolder& textures) const
 {
-	auto type = static_cast<PickupType>(Utility::RandomInt(static_cast<int>(PickupType::kPickupCount)));
+	auto type = static_cast<PickupType>(Utility::RandomInt(static_cast<int>(PickupType::kPickupCount), m_random));
 	std::unique_ptr<Pickup> pickup(new Pickup(type, textures));
 	pickup->setPosition(GetWorldPosition());
 	pickup->SetVelocity(0.f, 0.f);
@@ -709,7 +785,7 @@ void Aircraft::CreatePickup(SceneNode& node, const TextureHolder& textures) cons
 void Aircraft::CheckPickupDrop(CommandQueue& commands)
 {
 	//TODO Get rid of the magic number 3 here 
-	if (!IsAllied() && Utility::RandomInt(3) == 0 && !m_spawned_pickup)
+	if (!IsAllied() && Utility::RandomInt(3, m_random) == 0 && !m_spawned_pickup)
 	{
 		commands.Push(m_drop_pickup_command);
 	}
@@ -718,23 +794,23 @@ void Aircraft::CheckPickupDrop(CommandQueue& commands)
 
 void Aircraft::UpdateRollAnimation()
 {
-	if (Table[static_cast<int>(m_type)].m_has_roll_animation)
+	if (m_sprite && Table[static_cast<int>(m_type)].m_has_roll_animation)
 	{
 		//Flip sprite based on velocity
 		const float vx = GetVelocity().x;
-		sf::Vector2f currentScale = m_sprite.getScale();
+		sf::Vector2f currentScale = m_sprite->getScale();
 
 		if (vx < 0.f && currentScale.x > 0.f)
 		{
-			m_sprite.setScale(sf::Vector2f(-currentScale.x, currentScale.y));
+			m_sprite->setScale(sf::Vector2f(-currentScale.x, currentScale.y));
 		}
 		else if (vx > 0.f && currentScale.x < 0.f)
 		{
-			m_sprite.setScale(sf::Vector2f(-currentScale.x, currentScale.y));
+			m_sprite->setScale(sf::Vector2f(-currentScale.x, currentScale.y));
 		}
 
 		sf::IntRect textureRect = Table[static_cast<int>(m_type)].m_texture_rect;
-		m_sprite.setTextureRect(textureRect);
+		m_sprite->setTextureRect(textureRect);
 	}
 }
 
@@ -772,9 +848,14 @@ void Aircraft::Damage(int points)
 	}
 }
 
+void Aircraft::SeedRandom(unsigned int seed)
+{
+	m_random.seed(seed);
+}
+
 SoundEffect Aircraft::GetRandomJumpSound() const
 {
-	int random = std::rand() % 5;
+	int random = Utility::RandomInt(5, m_random);
 
 	switch (random)
 	{
@@ -789,7 +870,7 @@ SoundEffect Aircraft::GetRandomJumpSound() const
 
 SoundEffect Aircraft::GetRandomJumpLandSound() const
 {
-	int random = std::rand() % 2;
+	int random = Utility::RandomInt(2, m_random);
 
 	switch (random)
 	{
@@ -801,7 +882,7 @@ SoundEffect Aircraft::GetRandomJumpLandSound() const
 
 SoundEffect Aircraft::GetRandomHitSound() const
 {
-	int random = std::rand() % 2;
+	int random = Utility::RandomInt(2, m_random);
 
 	switch (random)
 	{
@@ -813,7 +894,7 @@ SoundEffect Aircraft::GetRandomHitSound() const
 
 SoundEffect Aircraft::GetRandomDeathSound() const
 {
-	int random = std::rand() % 1;
+	int random = Utility::RandomInt(1, m_random);
 
 	switch (random)
 	{
@@ -859,3 +940,9 @@ bool Aircraft::IsOnGround() const
 {
 	return m_is_on_ground;
 }
+
+void Aircraft::ClearPendingMovementSounds()
+{
+	m_just_jumped = false;
+	m_just_landed = false;
+}
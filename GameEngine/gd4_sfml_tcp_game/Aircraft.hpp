@@ -11,6 +11,7 @@
 #include "SpriteNode.hpp"
 #include "EmitterNode.hpp"
 #include <vector> 
+#include <optional>
 
 class Aircraft : public Entity
 {
@@ -31,6 +32,9 @@ public:
 	void ApplyPowerUp(PickupType type, sf::Time duration);
 	bool HasActivePowerUp(PickupType type) const;
 	float GetDamageMultiplier() const;
+	//Bit per PickupType, replicas are handed the server's set and keep it until the next snapshot changes it
+	unsigned int GetActivePowerUpMask() const;
+	void SetActivePowerUps(unsigned int mask);
 
 	void UpdateTexts();
 	void UpdateMovementPattern(sf::Time dt);
@@ -44,16 +48,22 @@ public:
 	sf::FloatRect GetBoundingRect() const override;
 	bool IsMarkedForRemoval() const override;
 	void PlayLocalSound(CommandQueue& commands, SoundEffect effect);
+	void SeedRandom(unsigned int seed);
 	void Damage(int points) override;
 
 	void Jump();
 	void SetOnGround(bool grounded);
 	bool IsOnGround() const;
+	//Replayed inputs already played their jump and landing sounds when they were first predicted
+	void ClearPendingMovementSounds();
 
 	void AttachGun(const TextureHolder& textures, TextureID textureId, const sf::IntRect& textureRect, const sf::Vector2f& offset);
 	void AimGunAt(const sf::Vector2f& worldPosition);
 	void SetGunOffset(const sf::Vector2f & offset);
 	sf::Vector2f GetGunOffset() const;
+	//Current on screen gun angle in degrees, setting it also snaps the aim target so the gun doesn't swing back
+	float GetGunRotation() const;
+	void SetGunRotation(float degrees);
 
 private:
 	virtual void DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
@@ -80,11 +90,12 @@ private:
 	};
 
 	AircraftType m_type;
-	sf::Sprite m_sprite;
-	Animation m_explosion;
+	std::optional<sf::Sprite> m_sprite;
+	std::optional<Animation> m_explosion;
+	sf::FloatRect m_local_bounds;
 
-	Animation m_idle_animation;
-	Animation m_run_animation;
+	std::optional<Animation> m_idle_animation;
+	std::optional<Animation> m_run_animation;
 	Animation* m_current_animation;
 	bool m_use_animations;
 	bool m_facing_right;
@@ -113,6 +124,8 @@ private:
 	bool m_show_explosion;
 	bool m_spawned_pickup;
 	bool m_played_explosion_sound;
+	//Drops and sound variations, seeded by the World so a match never shares random state with another
+	mutable std::default_random_engine m_random;
 
 	bool m_is_on_ground;
 	float m_jump_speed;
@@ -0,0 +1,75 @@
+#include "AllocationCounter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef COUNT_ALLOCATIONS
+namespace
+{
+	std::atomic<std::uint64_t> allocation_count{ 0 };
+
+	void* CountedAllocate(std::size_t size)
+	{
+		allocation_count.fetch_add(1, std::memory_order_relaxed);
+		if (size == 0)
+		{
+			size = 1;
+		}
+		if (void* memory = std::malloc(size))
+		{
+			return memory;
+		}
+		throw std::bad_alloc();
+	}
+}
+
+bool AllocationCounter::IsEnabled()
+{
+	return true;
+}
+
+std::uint64_t AllocationCounter::GetAllocationCount()
+{
+	return allocation_count.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+#else
+bool AllocationCounter::IsEnabled()
+{
+	return false;
+}
+
+std::uint64_t AllocationCounter::GetAllocationCount()
+{
+	return 0;
+}
+#endif
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+//Counts every allocation made through the global operator new so benchmarks can report allocations per tick
+//Only the Benchmark configuration defines COUNT_ALLOCATIONS, other builds keep the default operator new and always read 0
+class AllocationCounter
+{
+public:
+	static bool IsEnabled();
+	static std::uint64_t GetAllocationCount();
+};
@@ -6,11 +6,17 @@
 #include "SettingsState.hpp"
 #include "GameOverState.hpp"
 #include "BindingState.hpp"
+#include "ProfilerState.hpp"
+#include "NetworkGameState.hpp"
+#include "TraceRecorder.hpp"
+#include <cmath>
 
 const sf::Time Application::kTimePerFrame = sf::seconds(1.f/60.f);
+//Past this many catch-up ticks in one frame the rest of the backlog is dropped and the game runs slower instead
+const int Application::kMaxUpdatesPerFrame = 5;
 
 Application::Application() : m_window(sf::VideoMode({ 1024, 768 }), "States", sf::Style::Close)
-	, m_stack(State::Context(m_window, m_textures, m_fonts, m_player, m_music, m_sound))
+	, m_stack(State::Context(m_window, m_textures, m_fonts, m_player, m_music, m_sound, m_profiler, m_bindings))
 {
 	m_window.setKeyRepeatEnabled(false);
 	m_fonts.Load(Font::kMain, "Media/Fonts/Sansation.ttf");
@@ -30,10 +36,14 @@ void Application::Run()
 	sf::Time time_since_last_update = sf::Time::Zero;
 	while (m_window.isOpen())
 	{
+		ScopedTraceEvent frame_trace("Frame");
+		m_profiler.BeginFrame();
 		time_since_last_update += clock.restart();
-		while(time_since_last_update > kTimePerFrame)
+		int updates = 0;
+		while(time_since_last_update > kTimePerFrame && updates < kMaxUpdatesPerFrame)
 		{
 			time_since_last_update -= kTimePerFrame;
+			++updates;
 			ProcessInput();
 			Update(kTimePerFrame);
 
@@ -42,13 +52,22 @@ void Application::Run()
 				m_window.close();
 			}
 		}
-		Render();
 
+		//A frame too slow to catch up in kMaxUpdatesPerFrame ticks would only fall further behind, so forget the backlog
+		if (time_since_last_update > kTimePerFrame)
+		{
+			time_since_last_update = sf::seconds(std::fmod(time_since_last_update.asSeconds(), kTimePerFrame.asSeconds()));
+		}
+
+		//The leftover time puts the render between the last two ticks
+		Render(time_since_last_update / kTimePerFrame);
+		m_profiler.EndFrame();
 	}
 }
 
 void Application::ProcessInput()
 {
+	ScopedTraceEvent trace("Application::ProcessInput");
 	while (const std::optional event = m_window.pollEvent()) {
 		m_stack.HandleEvent(*event);
 		if (event->is<sf::Event::Closed>()) {
@@ -59,13 +78,15 @@ void Application::ProcessInput()
 
 void Application::Update(sf::Time dt)
 {
+	ScopedTraceEvent trace("Application::Update");
 	m_stack.Update(dt);
 }
 
-void Application::Render()
+void Application::Render(float interpolation_alpha)
 {
+	ScopedTraceEvent trace("Application::Render");
 	m_window.clear();
-	m_stack.Draw();
+	m_stack.Draw(interpolation_alpha);
 	m_window.display();
 }
 
@@ -78,4 +99,6 @@ void Application::RegisterStates()
 	m_stack.RegisterState<PauseState>(StateID::kPause);
 	m_stack.RegisterState<SettingsState>(StateID::kSettings);
 	m_stack.RegisterState<GameOverState>(StateID::kGameOver);
+	m_stack.RegisterState<ProfilerState>(StateID::kProfiler);
+	m_stack.RegisterState<NetworkGameState>(StateID::kNetworkGame);
 }
@@ -6,6 +6,8 @@
 #include "StateStack.hpp"
 #include "MusicPlayer.hpp"
 #include "SoundPlayer.hpp"
+#include "FrameProfiler.hpp"
+#include "PlayerBindingConfig.hpp"
 
 class Application
 {
@@ -16,7 +18,7 @@ public:
 private:
 	void ProcessInput();
 	void Update(sf::Time dt);
-	void Render();
+	void Render(float interpolation_alpha);
 	void RegisterStates();
 
 private:
@@ -28,8 +30,11 @@ private:
 
 	StateStack m_stack;
 	static const sf::Time kTimePerFrame;
+	static const int kMaxUpdatesPerFrame;
 
 	MusicPlayer m_music;
 	SoundPlayer m_sound;
+	FrameProfiler m_profiler;
+	PlayerBindingConfig m_bindings;
 };
 
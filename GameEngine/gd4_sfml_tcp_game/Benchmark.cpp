@@ -0,0 +1,415 @@
+#include "Benchmark.hpp"
+#include "AllocationCounter.hpp"
+#include "FrameProfiler.hpp"
+#include "World.hpp"
+#include "Box.hpp"
+#include "ParticleNode.hpp"
+#include "SpatialGrid.hpp"
+#include "SnapshotCodec.hpp"
+#include "SnapshotHistory.hpp"
+#include "NetworkConfig.hpp"
+#include "ServerMatch.hpp"
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+	const sf::Time kTimePerTick = sf::seconds(1.f / 60.f);
+	const float kArenaSize = 1280.f;
+
+	std::int64_t ElapsedNanoseconds(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	//Flat scene of colour boxes spread over the arena, the texture is irrelevant to the code under test
+	void BuildBoxField(SceneNode& root, int node_count, const std::function<sf::Vector2f()>& position)
+	{
+		for (int i = 0; i < node_count; ++i)
+		{
+			std::unique_ptr<Box> box(new Box({ 32.f, 32.f }, sf::Color::White));
+			box->setPosition(position());
+			root.AttachChild(std::move(box));
+		}
+	}
+}
+
+Benchmark::Benchmark()
+	: m_random(1234u)
+{
+}
+
+void Benchmark::Run()
+{
+	std::cout << std::fixed << std::setprecision(1);
+	if (!AllocationCounter::IsEnabled())
+	{
+		std::cout << "Allocations are only counted in the Benchmark configuration, allocs columns read 0" << std::endl;
+	}
+	std::cout << "=== World::Update scenarios ===" << std::endl;
+
+	RunWorldScenario("idle arena", 3000, nullptr, nullptr);
+
+	RunWorldScenario("2 players firing", 3000, nullptr, [](World& world)
+		{
+			for (int i = 0; i < 2; ++i)
+			{
+				if (Aircraft* player = world.GetPlayerAircraft(i))
+				{
+					player->Fire();
+				}
+			}
+		});
+
+	RunWorldScenario("500 projectiles", 600, nullptr, [this](World& world) { TopUpProjectiles(world, 500); });
+	RunWorldScenario("5000 projectiles", 30, nullptr, [this](World& world) { TopUpProjectiles(world, 5000); });
+	RunWorldScenario("50000 projectiles", 2, nullptr, [this](World& world) { TopUpProjectiles(world, 50000); });
+
+	RunWorldScenario("200 stacked boxes", 600, [](World& world)
+		{
+			//10 columns of 20 boxes resting on top of each other
+			for (int column = 0; column < 10; ++column)
+			{
+				for (int row = 0; row < 20; ++row)
+				{
+					world.SpawnBox({ 150.f + column * 100.f, 560.f - row * 64.f });
+				}
+			}
+		}, nullptr);
+
+	std::cout << "\n=== Scene graph micro benchmarks ===" << std::endl;
+	RunCollisionBenchmark(200, 2000);
+	RunCollisionBenchmark(1000, 500);
+	RunCollisionBenchmark(10000, 50);
+	RunCommandBenchmark(1000, 2000);
+	RunCommandBenchmark(10000, 200);
+	RunCommandQueueBenchmark(64, 20000);
+	RunRemoveWrecksBenchmark(1000, 2000);
+	RunRemoveWrecksBenchmark(10000, 200);
+	RunParticleBenchmark(1000, 2000);
+	RunParticleBenchmark(10000, 200);
+
+	std::cout << "\n=== Snapshot encoding ===" << std::endl;
+	RunSnapshotSizeBenchmark(1200, 6, 1);
+	RunSnapshotSizeBenchmark(1200, 6, NetworkConfig::kSnapshotInterval);
+
+	std::cout << "\n=== Multi-match hosting ===" << std::endl;
+	RunMatchHostBenchmark(8, 600);
+	RunMatchHostBenchmark(32, 300);
+}
+
+void Benchmark::RunWorldScenario(const std::string& name, int ticks, const ScenarioStep& setup, const ScenarioStep& before_tick)
+{
+	World world;
+	FrameProfiler profiler;
+	world.SetProfiler(&profiler);
+
+	if (setup)
+	{
+		setup(world);
+	}
+
+	std::uint64_t allocations = 0;
+	for (int i = 0; i < ticks; ++i)
+	{
+		//Scenario scripting is not part of the measured tick
+		if (before_tick)
+		{
+			before_tick(world);
+		}
+
+		std::uint64_t allocations_before = AllocationCounter::GetAllocationCount();
+		profiler.BeginFrame();
+		world.Update(kTimePerTick);
+		profiler.EndFrame();
+		allocations += AllocationCounter::GetAllocationCount() - allocations_before;
+	}
+
+	double frames = static_cast<double>(profiler.GetFrameCount());
+	std::cout << std::left << std::setw(20) << name << std::right
+		<< std::setw(14) << profiler.GetTotalNanoseconds() / frames << " ns/tick"
+		<< std::setw(10) << allocations / frames << " allocs/tick" << std::endl;
+
+	for (int phase = 0; phase < static_cast<int>(ProfilePhase::kPhaseCount); ++phase)
+	{
+		ProfilePhase profile_phase = static_cast<ProfilePhase>(phase);
+		std::cout << "    " << std::left << std::setw(16) << FrameProfiler::GetPhaseName(profile_phase) << std::right
+			<< std::setw(14) << profiler.GetPhaseNanoseconds(profile_phase) / frames << " ns" << std::endl;
+	}
+}
+
+void Benchmark::TopUpProjectiles(World& world, std::size_t live_count)
+{
+	std::size_t current = world.CountEntities(ReceiverCategories::kProjectile);
+	std::uniform_real_distribution<float> speed(-400.f, 400.f);
+	for (; current < live_count; ++current)
+	{
+		world.SpawnProjectile(ProjectileType::kAlliedBullet, RandomPosition(), { speed(m_random), 0.f });
+	}
+}
+
+void Benchmark::RunCollisionBenchmark(int node_count, int iterations)
+{
+	SceneNode root;
+	BuildBoxField(root, node_count, [this]() { return RandomPosition(); });
+
+	//Same grid setup World uses for HandleCollisions
+	SpatialGrid grid({ { 0.f, 0.f }, { kArenaSize, kArenaSize } }, 128.f);
+	std::vector<SceneNode::Pair> collision_pairs;
+	std::int64_t nanoseconds = 0;
+	std::uint64_t allocations_before = AllocationCounter::GetAllocationCount();
+	for (int i = 0; i < iterations; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		grid.Clear();
+		root.CollectCollidables(grid, World::GetCollisionTable());
+		collision_pairs.clear();
+		grid.FindPairs(collision_pairs);
+		nanoseconds += ElapsedNanoseconds(start);
+	}
+
+	PrintMicroResult("Broadphase " + std::to_string(node_count), iterations, nanoseconds, AllocationCounter::GetAllocationCount() - allocations_before);
+}
+
+void Benchmark::RunCommandBenchmark(int node_count, int iterations)
+{
+	SceneNode root;
+	root.EnableCategoryIndex();
+	BuildBoxField(root, node_count, [this]() { return RandomPosition(); });
+
+	Command command;
+	command.category = static_cast<int>(ReceiverCategories::kBox);
+	command.action = DerivedAction<Entity>([](Entity& e, sf::Time)
+		{
+			e.AddForce({ 0.f, 1.f });
+		});
+
+	std::int64_t nanoseconds = 0;
+	std::uint64_t allocations_before = AllocationCounter::GetAllocationCount();
+	for (int i = 0; i < iterations; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		root.OnCommand(command, kTimePerTick);
+		nanoseconds += ElapsedNanoseconds(start);
+	}
+
+	PrintMicroResult("OnCommand " + std::to_string(node_count), iterations, nanoseconds, AllocationCounter::GetAllocationCount() - allocations_before);
+}
+
+void Benchmark::RunCommandQueueBenchmark(int commands_per_tick, int iterations)
+{
+	SceneNode root;
+	CommandQueue queue;
+
+	//Same shape as the sound commands Aircraft queues every tick
+	const sf::Vector2f position = RandomPosition();
+	std::int64_t nanoseconds = 0;
+	std::uint64_t allocations_before = AllocationCounter::GetAllocationCount();
+	for (int i = 0; i < iterations; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int j = 0; j < commands_per_tick; ++j)
+		{
+			Command command;
+			command.category = static_cast<int>(ReceiverCategories::kSoundEffect);
+			command.action = [position, j](SceneNode& node, sf::Time)
+				{
+					node.setPosition(position + sf::Vector2f(static_cast<float>(j), 0.f));
+				};
+			queue.Push(command);
+		}
+		while (!queue.IsEmpty())
+		{
+			queue.Pop().action(root, kTimePerTick);
+		}
+		nanoseconds += ElapsedNanoseconds(start);
+	}
+
+	PrintMicroResult("CommandQueue " + std::to_string(commands_per_tick), iterations, nanoseconds, AllocationCounter::GetAllocationCount() - allocations_before);
+}
+
+void Benchmark::RunRemoveWrecksBenchmark(int node_count, int iterations)
+{
+	SceneNode root;
+	root.EnableCategoryIndex();
+	std::vector<Box*> boxes;
+	for (int i = 0; i < node_count; ++i)
+	{
+		std::unique_ptr<Box> box(new Box({ 32.f, 32.f }, sf::Color::White));
+		boxes.push_back(box.get());
+		root.AttachChild(std::move(box));
+	}
+
+	//Each iteration destroys 10% of the nodes, removes them and then replaces them outside the timed region
+	const int wrecks_per_iteration = std::max(1, node_count / 10);
+	std::int64_t nanoseconds = 0;
+	std::uint64_t allocations = 0;
+	for (int i = 0; i < iterations; ++i)
+	{
+		std::shuffle(boxes.begin(), boxes.end(), m_random);
+		for (int w = 0; w < wrecks_per_iteration; ++w)
+		{
+			boxes[w]->Destroy();
+		}
+
+		std::uint64_t allocations_before = AllocationCounter::GetAllocationCount();
+		auto start = std::chrono::steady_clock::now();
+		root.RemoveWrecks();
+		nanoseconds += ElapsedNanoseconds(start);
+		allocations += AllocationCounter::GetAllocationCount() - allocations_before;
+
+		for (int w = 0; w < wrecks_per_iteration; ++w)
+		{
+			std::unique_ptr<Box> box(new Box({ 32.f, 32.f }, sf::Color::White));
+			boxes[w] = box.get();
+			root.AttachChild(std::move(box));
+		}
+	}
+
+	PrintMicroResult("RemoveWrecks " + std::to_string(node_count), iterations, nanoseconds, allocations);
+}
+
+void Benchmark::RunParticleBenchmark(int particle_count, int iterations)
+{
+	TextureHolder no_textures;
+	ParticleNode particles(ParticleType::kSmoke, no_textures);
+	for (int i = 0; i < particle_count; ++i)
+	{
+		particles.AddParticle(RandomPosition());
+	}
+
+	std::int64_t nanoseconds = 0;
+	std::uint64_t allocations_before = AllocationCounter::GetAllocationCount();
+	for (int i = 0; i < iterations; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		particles.ComputeVertices();
+		nanoseconds += ElapsedNanoseconds(start);
+	}
+
+	PrintMicroResult("ComputeVertices " + std::to_string(particle_count), iterations, nanoseconds, AllocationCounter::GetAllocationCount() - allocations_before);
+}
+
+void Benchmark::RunSnapshotSizeBenchmark(int ticks, int ack_delay_ticks, int snapshot_interval)
+{
+	//Two players firing nonstop, every snapshot_interval ticks encoded whole and as a delta against the one a client ~100ms behind would have acknowledged
+	World world;
+	WorldSnapshot snapshot;
+	SnapshotHistory history;
+	BitWriter writer;
+	std::size_t full_bits = 0;
+	std::size_t delta_bits = 0;
+	std::size_t entity_count = 0;
+	std::int64_t nanoseconds = 0;
+	std::uint64_t allocations = 0;
+
+	for (int tick = 1; tick <= ticks; ++tick)
+	{
+		for (int i = 0; i < 2; ++i)
+		{
+			if (Aircraft* player = world.GetPlayerAircraft(i))
+			{
+				player->Fire();
+			}
+		}
+		world.Update(kTimePerTick);
+		if (tick % snapshot_interval != 0)
+			continue;
+
+		std::uint64_t allocations_before = AllocationCounter::GetAllocationCount();
+		auto start = std::chrono::steady_clock::now();
+		world.CaptureSnapshot(snapshot);
+		snapshot.tick = static_cast<std::uint32_t>(tick);
+		SnapshotCodec::Quantize(snapshot);
+		history.Store(snapshot);
+
+		writer.Clear();
+		SnapshotCodec::Write(writer, snapshot, history.Find(snapshot.tick - ack_delay_ticks));
+		delta_bits += writer.GetBitCount();
+		nanoseconds += ElapsedNanoseconds(start);
+		allocations += AllocationCounter::GetAllocationCount() - allocations_before;
+
+		writer.Clear();
+		SnapshotCodec::Write(writer, snapshot, nullptr);
+		full_bits += writer.GetBitCount();
+		entity_count += snapshot.entities.size();
+	}
+
+	const int snapshots = ticks / snapshot_interval;
+	const double rate = 60.0 / snapshot_interval;
+	const double full_bytes = full_bits / 8.0 / snapshots;
+	const double delta_bytes = delta_bits / 8.0 / snapshots;
+	std::cout << "Average " << static_cast<double>(entity_count) / snapshots << " entities per snapshot" << std::endl;
+	std::cout << "Full snapshot  " << std::setw(10) << full_bytes << " bytes, " << full_bytes * 8.0 * rate / 1000.0 << " kbit/s at " << rate << " Hz" << std::endl;
+	std::cout << "Delta snapshot " << std::setw(10) << delta_bytes << " bytes, " << delta_bytes * 8.0 * rate / 1000.0 << " kbit/s at " << rate << " Hz" << std::endl;
+	PrintMicroResult("Capture + delta encode", snapshots, nanoseconds, allocations);
+}
+
+void Benchmark::RunMatchHostBenchmark(int match_count, int ticks)
+{
+	//Every player runs back and forth firing nonstop, the same matches are stepped one after another and then on the pool
+	std::vector<std::unique_ptr<ServerMatch>> matches;
+	for (int i = 0; i < match_count; ++i)
+	{
+		matches.push_back(std::make_unique<ServerMatch>(static_cast<unsigned int>(i)));
+	}
+	WorkerPool pool;
+
+	const unsigned int fire = Player::GetActionBit(Action::kBulletFire);
+	auto submit_inputs = [&matches, fire](std::uint32_t tick)
+		{
+			PlayerInput input;
+			input.tick = tick;
+			input.actions = static_cast<std::uint8_t>(fire | Player::GetActionBit((tick / 60) % 2 ? Action::kMoveLeft : Action::kMoveRight));
+			for (auto& match : matches)
+			{
+				for (int player = 0; player < ServerMatch::kMaxPlayers; ++player)
+				{
+					match->SubmitInput(player, input);
+				}
+			}
+		};
+
+	std::int64_t sequential = 0;
+	std::int64_t pooled = 0;
+	for (int tick = 1; tick <= ticks; ++tick)
+	{
+		submit_inputs(static_cast<std::uint32_t>(tick * 2 - 1));
+		auto start = std::chrono::steady_clock::now();
+		for (auto& match : matches)
+		{
+			match->Update(kTimePerTick);
+		}
+		sequential += ElapsedNanoseconds(start);
+
+		submit_inputs(static_cast<std::uint32_t>(tick * 2));
+		start = std::chrono::steady_clock::now();
+		pool.Run(match_count, [&matches](int i)
+			{
+				matches[i]->Update(kTimePerTick);
+			});
+		pooled += ElapsedNanoseconds(start);
+	}
+
+	const double budget = kTimePerTick.asMicroseconds() * 1000.0;
+	std::cout << match_count << " matches, " << pool.GetThreadCount() << " threads: sequential "
+		<< sequential / 1.0e6 / ticks << " ms/tick, pooled " << pooled / 1.0e6 / ticks << " ms/tick, "
+		<< budget / 1.0e6 << " ms budget, " << 100.0 * pooled / ticks / budget << "% used" << std::endl;
+}
+
+void Benchmark::PrintMicroResult(const std::string& name, int iterations, std::int64_t nanoseconds, std::uint64_t allocations) const
+{
+	std::cout << std::left << std::setw(28) << name << std::right
+		<< std::setw(14) << static_cast<double>(nanoseconds) / iterations << " ns/call"
+		<< std::setw(10) << static_cast<double>(allocations) / iterations << " allocs/call" << std::endl;
+}
+
+sf::Vector2f Benchmark::RandomPosition()
+{
+	std::uniform_real_distribution<float> coordinate(0.f, kArenaSize);
+	return { coordinate(m_random), coordinate(m_random) };
+}
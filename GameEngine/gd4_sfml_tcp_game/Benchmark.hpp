@@ -0,0 +1,38 @@
+#pragma once
+#include "ReceiverCategories.hpp"
+#include <SFML/System/Vector2.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+
+class World;
+
+//Repeatable timings for World::Update scenarios and the scene graph hot paths, run with --benchmark
+class Benchmark
+{
+public:
+	Benchmark();
+	void Run();
+
+private:
+	typedef std::function<void(World&)> ScenarioStep;
+
+	void RunWorldScenario(const std::string& name, int ticks, const ScenarioStep& setup, const ScenarioStep& before_tick);
+	void TopUpProjectiles(World& world, std::size_t live_count);
+
+	void RunCollisionBenchmark(int node_count, int iterations);
+	void RunCommandBenchmark(int node_count, int iterations);
+	void RunCommandQueueBenchmark(int commands_per_tick, int iterations);
+	void RunRemoveWrecksBenchmark(int node_count, int iterations);
+	void RunParticleBenchmark(int particle_count, int iterations);
+	void RunSnapshotSizeBenchmark(int ticks, int ack_delay_ticks, int snapshot_interval);
+	void RunMatchHostBenchmark(int match_count, int ticks);
+
+	void PrintMicroResult(const std::string& name, int iterations, std::int64_t nanoseconds, std::uint64_t allocations) const;
+	sf::Vector2f RandomPosition();
+
+private:
+	std::mt19937 m_random;
+};
@@ -103,8 +103,8 @@ bool BindingState::HandleEvent(const sf::Event& event)
 				std::cout << "[BindingState] Starting game with bindings:\n";
 				GetContext().sounds->Play(SoundEffect::kStartGame);
 
-				//Save bindings to global config
-				auto& config = PlayerBindingConfig::GetInstance();
+				//Save bindings for the game state
+				PlayerBindingConfig& config = *GetContext().bindings;
 				for (int i = 0; i < kMaxPlayers; ++i)
 				{
 					auto device = m_binding_manager.GetPlayerDevice(i);
@@ -0,0 +1,119 @@
+#include "BitStream.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+	std::uint32_t ToStepIndex(float value, float min, float step, int bits)
+	{
+		const float max_index = static_cast<float>((std::uint64_t(1) << bits) - 1);
+		float index = std::round((value - min) / step);
+		return static_cast<std::uint32_t>(std::clamp(index, 0.f, max_index));
+	}
+}
+
+BitWriter::BitWriter() : m_bit_count(0)
+{
+}
+
+void BitWriter::Clear()
+{
+	m_bytes.clear();
+	m_bit_count = 0;
+}
+
+void BitWriter::Write(std::uint32_t value, int bits)
+{
+	assert(bits > 0 && bits <= 32);
+	assert(bits == 32 || value < (std::uint32_t(1) << bits));
+
+	for (int i = 0; i < bits; ++i)
+	{
+		if (m_bit_count % 8 == 0)
+		{
+			m_bytes.push_back(0);
+		}
+		if ((value >> i) & 1u)
+		{
+			m_bytes.back() |= static_cast<std::uint8_t>(1u << (m_bit_count % 8));
+		}
+		++m_bit_count;
+	}
+}
+
+void BitWriter::WriteBool(bool value)
+{
+	Write(value ? 1u : 0u, 1);
+}
+
+void BitWriter::WriteQuantized(float value, float min, float step, int bits)
+{
+	Write(ToStepIndex(value, min, step, bits), bits);
+}
+
+float BitWriter::Quantize(float value, float min, float step, int bits)
+{
+	return min + static_cast<float>(ToStepIndex(value, min, step, bits)) * step;
+}
+
+std::size_t BitWriter::GetBitCount() const
+{
+	return m_bit_count;
+}
+
+void BitWriter::AppendTo(sf::Packet& packet) const
+{
+	if (!m_bytes.empty())
+	{
+		packet.append(m_bytes.data(), m_bytes.size());
+	}
+}
+
+BitReader::BitReader(const sf::Packet& packet)
+	: BitReader(static_cast<const std::uint8_t*>(packet.getData()) + packet.getReadPosition(), packet.getDataSize() - packet.getReadPosition())
+{
+}
+
+BitReader::BitReader(const void* data, std::size_t size)
+	: m_data(static_cast<const std::uint8_t*>(data))
+	, m_bit_size(size * 8)
+	, m_bit_position(0)
+	, m_valid(true)
+{
+}
+
+std::uint32_t BitReader::Read(int bits)
+{
+	assert(bits > 0 && bits <= 32);
+	if (m_bit_position + bits > m_bit_size)
+	{
+		m_valid = false;
+		m_bit_position = m_bit_size;
+		return 0;
+	}
+
+	std::uint32_t value = 0;
+	for (int i = 0; i < bits; ++i)
+	{
+		std::uint32_t bit = (m_data[m_bit_position / 8] >> (m_bit_position % 8)) & 1u;
+		value |= bit << i;
+		++m_bit_position;
+	}
+	return value;
+}
+
+bool BitReader::ReadBool()
+{
+	return Read(1) != 0;
+}
+
+float BitReader::ReadQuantized(float min, float step, int bits)
+{
+	return min + static_cast<float>(Read(bits)) * step;
+}
+
+bool BitReader::IsValid() const
+{
+	return m_valid;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <SFML/Network/Packet.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//Packs values into the fewest bits they need, least significant bit first, for appending to an sf::Packet
+class BitWriter
+{
+public:
+	BitWriter();
+	void Clear();
+	//value must fit in bits, which is at most 32
+	void Write(std::uint32_t value, int bits);
+	void WriteBool(bool value);
+	//Rounds value to the nearest step inside [min, min + step * 2^bits) and writes the step index
+	void WriteQuantized(float value, float min, float step, int bits);
+	//The value a WriteQuantized/ReadQuantized round trip produces, so both ends can agree on it up front
+	static float Quantize(float value, float min, float step, int bits);
+
+	std::size_t GetBitCount() const;
+	//Appends the written bytes, the last one padded with zero bits
+	void AppendTo(sf::Packet& packet) const;
+
+private:
+	std::vector<std::uint8_t> m_bytes;
+	std::size_t m_bit_count;
+};
+
+//Reads what a BitWriter wrote, reading past the end yields zeros and marks the reader invalid
+class BitReader
+{
+public:
+	//Reads the rest of packet from its current read position
+	explicit BitReader(const sf::Packet& packet);
+	BitReader(const void* data, std::size_t size);
+	std::uint32_t Read(int bits);
+	bool ReadBool();
+	float ReadQuantized(float min, float step, int bits);
+	bool IsValid() const;
+
+private:
+	const std::uint8_t* m_data;
+	std::size_t m_bit_size;
+	std::size_t m_bit_position;
+	bool m_valid;
+};
@@ -17,6 +17,20 @@ public:
         SetUsePhysics(true);
         SetMass(1.0f);
         SetLinearDrag(1.0f);
+        SetCanSleep(true);
+    }
+
+    explicit Box(const sf::Vector2f& size, const sf::Color& color)
+        : Entity(1)
+        , m_shape(size)
+    {
+        m_shape.setOrigin(size * 0.5f);
+        m_shape.setFillColor(color);
+
+        SetUsePhysics(true);
+        SetMass(1.0f);
+        SetLinearDrag(1.0f);
+        SetCanSleep(true);
     }
 
     void SetSize(const sf::Vector2f& size)
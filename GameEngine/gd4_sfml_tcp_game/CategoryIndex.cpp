@@ -0,0 +1,46 @@
+#include "CategoryIndex.hpp"
+#include "SceneNode.hpp"
+#include <algorithm>
+#include <bit>
+
+void CategoryIndex::Add(SceneNode& node)
+{
+	const unsigned int category = node.GetCategory();
+	for (unsigned int bits = category; bits != 0; bits &= bits - 1)
+	{
+		m_receivers[std::countr_zero(bits)].push_back({ &node, category });
+	}
+}
+
+void CategoryIndex::Dispatch(const Command& command, sf::Time dt)
+{
+	for (unsigned int bits = command.category; bits != 0; bits &= bits - 1)
+	{
+		const int bit = std::countr_zero(bits);
+		const unsigned int lower_bits = (1u << bit) - 1u;
+
+		//Actions can attach new nodes, which may grow this vector, so index it and stop at the size from before dispatch
+		std::vector<Receiver>& receivers = m_receivers[bit];
+		const std::size_t count = receivers.size();
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const Receiver receiver = receivers[i];
+			//A node listed under several matching bits only runs the command for the lowest one
+			if (receiver.m_category & command.category & lower_bits)
+				continue;
+
+			command.action(*receiver.m_node, dt);
+		}
+	}
+}
+
+void CategoryIndex::RemoveFlagged()
+{
+	for (std::vector<Receiver>& receivers : m_receivers)
+	{
+		receivers.erase(std::remove_if(receivers.begin(), receivers.end(), [](const Receiver& receiver)
+			{
+				return receiver.m_node->m_removal_flagged;
+			}), receivers.end());
+	}
+}
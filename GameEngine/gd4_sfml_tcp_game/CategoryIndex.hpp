@@ -0,0 +1,31 @@
+#pragma once
+#include "Command.hpp"
+#include <SFML/System/Time.hpp>
+
+#include <array>
+#include <vector>
+
+class SceneNode;
+
+//Receivers of each category bit, owned by the root of a scene graph so commands only visit matching nodes
+//A node's category is read once when it is attached and must not change while it is in the graph
+class CategoryIndex
+{
+public:
+	void Add(SceneNode& node);
+	void Dispatch(const Command& command, sf::Time dt);
+	//Drops every node flagged for removal by SceneNode::RemoveWrecks or DetachChild
+	void RemoveFlagged();
+
+private:
+	struct Receiver
+	{
+		SceneNode* m_node;
+		unsigned int m_category;
+	};
+
+	static const int kBitCount = 32;
+
+private:
+	std::array<std::vector<Receiver>, kBitCount> m_receivers;
+};
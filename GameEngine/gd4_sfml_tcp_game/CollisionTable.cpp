@@ -0,0 +1,79 @@
+#include "CollisionTable.hpp"
+#include "SceneNode.hpp"
+#include <bit>
+#include <cassert>
+
+CollisionTable::CollisionTable()
+	: m_entries()
+	, m_masks()
+	, m_static_categories(0)
+{
+}
+
+void CollisionTable::Register(ReceiverCategories first, ReceiverCategories second, Handler handler)
+{
+	const unsigned int first_bits = static_cast<unsigned int>(first);
+	const unsigned int second_bits = static_cast<unsigned int>(second);
+	assert(std::bit_width(first_bits | second_bits) <= kCategoryBits);
+
+	for (int a = 0; a < kCategoryBits; ++a)
+	{
+		if (!(first_bits & (1u << a)))
+			continue;
+		for (int b = 0; b < kCategoryBits; ++b)
+		{
+			if (!(second_bits & (1u << b)))
+				continue;
+
+			//Within one category the broadphase order is kept
+			m_entries[b][a] = { handler, a != b };
+			m_entries[a][b] = { handler, false };
+			m_masks[a] |= 1u << b;
+			m_masks[b] |= 1u << a;
+		}
+	}
+}
+
+void CollisionTable::SetStatic(ReceiverCategories categories)
+{
+	m_static_categories |= static_cast<unsigned int>(categories);
+}
+
+unsigned int CollisionTable::GetMask(unsigned int category) const
+{
+	if (category == 0)
+		return 0;
+	return m_masks[GetBit(category)];
+}
+
+unsigned int CollisionTable::GetSleepingMask(unsigned int category) const
+{
+	return GetMask(category) & ~m_static_categories;
+}
+
+bool CollisionTable::IsStatic(unsigned int category) const
+{
+	return (category & m_static_categories) != 0;
+}
+
+void CollisionTable::Dispatch(World& world, SceneNode& lhs, SceneNode& rhs) const
+{
+	const Entry& entry = m_entries[GetBit(lhs.GetCategory())][GetBit(rhs.GetCategory())];
+	if (!entry.handler)
+		return;
+
+	if (entry.swapped)
+	{
+		(world.*entry.handler)(rhs, lhs);
+	}
+	else
+	{
+		(world.*entry.handler)(lhs, rhs);
+	}
+}
+
+int CollisionTable::GetBit(unsigned int category)
+{
+	const int bit = std::countr_zero(category);
+	return bit < kCategoryBits ? bit : kCategoryBits - 1;
+}
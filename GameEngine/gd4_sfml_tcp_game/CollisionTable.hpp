@@ -0,0 +1,44 @@
+#pragma once
+#include "ReceiverCategories.hpp"
+#include <array>
+
+class SceneNode;
+class World;
+
+//Collision responses looked up by the category bits of the two nodes, instead of testing every pair against every response
+//A category's mask holds every category it has a response with, the broadphase drops pairs whose masks miss each other
+class CollisionTable
+{
+public:
+	//Gets the nodes in the order their categories were registered in, whichever order the broadphase found them in
+	using Handler = void (World::*)(SceneNode& first, SceneNode& second);
+	static const int kCategoryBits = 16;
+	//Sleeping nodes go into the broadphase this much larger on every side, so bodies only touching them still come out as pairs
+	static constexpr float kSleepingMargin = 1.f;
+
+	CollisionTable();
+	//Every category bit in first against every one in second, registering a pair again replaces its response
+	void Register(ReceiverCategories first, ReceiverCategories second, Handler handler);
+	//Static categories never move, a sleeping body is not tested against them
+	void SetStatic(ReceiverCategories categories);
+	//Zero for a node with no response to anything, it is not worth putting in the broadphase
+	unsigned int GetMask(unsigned int category) const;
+	unsigned int GetSleepingMask(unsigned int category) const;
+	bool IsStatic(unsigned int category) const;
+	void Dispatch(World& world, SceneNode& lhs, SceneNode& rhs) const;
+
+private:
+	struct Entry
+	{
+		Handler handler = nullptr;
+		bool swapped = false;
+	};
+
+	//Collidable nodes carry a single category bit, the lowest one is used if there are more
+	static int GetBit(unsigned int category);
+
+private:
+	std::array<std::array<Entry, kCategoryBits>, kCategoryBits> m_entries;
+	std::array<unsigned int, kCategoryBits> m_masks;
+	unsigned int m_static_categories;
+};
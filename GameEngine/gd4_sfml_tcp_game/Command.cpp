@@ -1,5 +1,9 @@
 #include "Command.hpp"
 
+CommandAction::CommandAction() : m_invoker(nullptr)
+{
+}
+
 Command::Command() : action(), category(static_cast<unsigned int>(ReceiverCategories::kNone))
 {
 }
@@ -1,22 +1,88 @@
 #pragma once
-#include <functional>
 #include <SFML/System/Time.hpp>
 #include "ReceiverCategories.hpp"
 #include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 class SceneNode;
 
+//Type erased void(SceneNode&, sf::Time) callable stored inline, so building, copying and queueing commands never allocates
+//Callables must be trivially copyable (plain captures such as this, pointers, references and values) and fit in kStorageSize
+class CommandAction
+{
+public:
+	static const std::size_t kStorageSize = 32;
+
+public:
+	CommandAction();
+
+	template<typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, CommandAction>>>
+	CommandAction(Function fn);
+
+	template<typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, CommandAction>>>
+	CommandAction& operator=(Function fn);
+
+	void operator()(SceneNode& node, sf::Time dt) const;
+	explicit operator bool() const;
+
+private:
+	typedef void(*Invoker)(const void*, SceneNode&, sf::Time);
+
+	template<typename Function>
+	static void Invoke(const void* storage, SceneNode& node, sf::Time dt);
+
+private:
+	alignas(std::max_align_t) unsigned char m_storage[kStorageSize];
+	Invoker m_invoker;
+};
 
 struct Command
 {
 	Command();
-	std::function<void(SceneNode&, sf::Time)> action;
+	CommandAction action;
 	unsigned int category;
 };
 
+template<typename Function, typename>
+CommandAction::CommandAction(Function fn)
+	: m_invoker(&Invoke<Function>)
+{
+	static_assert(sizeof(Function) <= kStorageSize, "Command action captures too much state, capture a pointer instead");
+	static_assert(alignof(Function) <= alignof(std::max_align_t), "Command action is over-aligned");
+	static_assert(std::is_trivially_copyable<Function>::value && std::is_trivially_destructible<Function>::value,
+		"Command action must only capture trivially copyable state");
+	::new (static_cast<void*>(m_storage)) Function(std::move(fn));
+}
+
+template<typename Function, typename>
+CommandAction& CommandAction::operator=(Function fn)
+{
+	*this = CommandAction(std::move(fn));
+	return *this;
+}
+
+template<typename Function>
+void CommandAction::Invoke(const void* storage, SceneNode& node, sf::Time dt)
+{
+	(*std::launder(static_cast<const Function*>(storage)))(node, dt);
+}
+
+inline void CommandAction::operator()(SceneNode& node, sf::Time dt) const
+{
+	assert(m_invoker != nullptr);
+	m_invoker(m_storage, node, dt);
+}
+
+inline CommandAction::operator bool() const
+{
+	return m_invoker != nullptr;
+}
+
 template<typename GameObject, typename Function>
-std::function<void(SceneNode&, sf::Time)>
-DerivedAction(Function fn)
+auto DerivedAction(Function fn)
 {
 	return [=](SceneNode& node, sf::Time dt)
 		{
@@ -26,5 +92,3 @@ DerivedAction(Function fn)
 			fn(static_cast<GameObject&>(node), dt);
 		};
 }
-
-
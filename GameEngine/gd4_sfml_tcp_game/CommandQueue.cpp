@@ -1,18 +1,51 @@
 #include "CommandQueue.hpp"
+#include <utility>
+
+CommandQueue::CommandQueue(std::size_t capacity)
+    : m_buffer(capacity > 0 ? capacity : 1)
+    , m_head(0)
+    , m_size(0)
+{
+}
 
 void CommandQueue::Push(const Command& command)
 {
-    m_queue.push(command);
+    if (m_size == m_buffer.size())
+    {
+        Grow();
+    }
+
+    m_buffer[(m_head + m_size) % m_buffer.size()] = command;
+    ++m_size;
 }
 
 Command CommandQueue::Pop()
 {
-    Command command = m_queue.front();
-    m_queue.pop();
+    assert(m_size > 0);
+    Command command = std::move(m_buffer[m_head]);
+    m_head = (m_head + 1) % m_buffer.size();
+    --m_size;
     return command;
 }
 
 bool CommandQueue::IsEmpty() const
 {
-    return m_queue.empty();
+    return m_size == 0;
+}
+
+std::size_t CommandQueue::GetCapacity() const
+{
+    return m_buffer.size();
+}
+
+void CommandQueue::Grow()
+{
+    //Unwrap the pending commands to the front of a buffer twice the size
+    std::vector<Command> buffer(m_buffer.size() * 2);
+    for (std::size_t i = 0; i < m_size; ++i)
+    {
+        buffer[i] = std::move(m_buffer[(m_head + i) % m_buffer.size()]);
+    }
+    m_buffer.swap(buffer);
+    m_head = 0;
 }
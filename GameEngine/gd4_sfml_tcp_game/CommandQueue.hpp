@@ -1,15 +1,26 @@
 #pragma once
 #include "Command.hpp"
-#include <queue>
+#include <cstddef>
+#include <vector>
 
+//FIFO ring buffer over preallocated storage, it only allocates when a tick pushes more commands than ever before
 class CommandQueue
 {
 public:
+	static const std::size_t kDefaultCapacity = 256;
+
+public:
+	explicit CommandQueue(std::size_t capacity = kDefaultCapacity);
 	void Push(const Command& command);
 	Command Pop();
 	bool IsEmpty() const;
+	std::size_t GetCapacity() const;
 
 private:
-	std::queue<Command> m_queue;
-};
+	void Grow();
 
+private:
+	std::vector<Command> m_buffer;
+	std::size_t m_head;
+	std::size_t m_size;
+};
@@ -0,0 +1,182 @@
+#include "ContactSolver.hpp"
+#include "Entity.hpp"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	sf::Vector2f GetCenter(const sf::FloatRect& rect)
+	{
+		return { rect.position.x + rect.size.x * 0.5f, rect.position.y + rect.size.y * 0.5f };
+	}
+
+	float Dot(const sf::Vector2f& a, const sf::Vector2f& b)
+	{
+		return a.x * b.x + a.y * b.y;
+	}
+
+	float GetInverseMass(const Entity* body)
+	{
+		return body ? 1.f / body->GetMass() : 0.f;
+	}
+}
+
+bool ContactSolver::FindContact(const sf::FloatRect& first, const sf::FloatRect& second, sf::Vector2f& normal, float& depth)
+{
+	const sf::Vector2f delta = GetCenter(first) - GetCenter(second);
+	const float overlap_x = (first.size.x + second.size.x) * 0.5f - std::abs(delta.x);
+	const float overlap_y = (first.size.y + second.size.y) * 0.5f - std::abs(delta.y);
+	if (overlap_x <= 0.f || overlap_y <= 0.f)
+		return false;
+
+	if (overlap_x < overlap_y)
+	{
+		normal = { delta.x > 0.f ? 1.f : -1.f, 0.f };
+		depth = overlap_x;
+	}
+	else
+	{
+		normal = { 0.f, delta.y > 0.f ? 1.f : -1.f };
+		depth = overlap_y;
+	}
+	return true;
+}
+
+bool ContactSolver::FindTimeOfImpact(const sf::FloatRect& first, sf::Vector2f motion, const sf::FloatRect& second, float& time, sf::Vector2f& normal)
+{
+	//second is grown by first's size so first's top left corner can be traced as a ray through it, one slab per axis
+	const float starts[2] = { first.position.x, first.position.y };
+	const float deltas[2] = { motion.x, motion.y };
+	const float mins[2] = { second.position.x - first.size.x, second.position.y - first.size.y };
+	const float maxs[2] = { second.position.x + second.size.x, second.position.y + second.size.y };
+
+	float entry = -std::numeric_limits<float>::max();
+	float exit = std::numeric_limits<float>::max();
+	sf::Vector2f entry_normal;
+	for (int axis = 0; axis < 2; ++axis)
+	{
+		if (deltas[axis] == 0.f)
+		{
+			//Not moving on this axis, the slabs have to overlap the whole time
+			if (starts[axis] <= mins[axis] || starts[axis] >= maxs[axis])
+				return false;
+			continue;
+		}
+
+		float near_time = (mins[axis] - starts[axis]) / deltas[axis];
+		float far_time = (maxs[axis] - starts[axis]) / deltas[axis];
+		if (near_time > far_time)
+		{
+			std::swap(near_time, far_time);
+		}
+		if (near_time > entry)
+		{
+			entry = near_time;
+			entry_normal = axis == 0 ? sf::Vector2f(deltas[0] > 0.f ? -1.f : 1.f, 0.f) : sf::Vector2f(0.f, deltas[1] > 0.f ? -1.f : 1.f);
+		}
+		exit = std::min(exit, far_time);
+	}
+
+	if (entry >= exit || entry < 0.f || entry > 1.f)
+		return false;
+
+	time = entry;
+	normal = entry_normal;
+	return true;
+}
+
+void ContactSolver::Clear()
+{
+	m_manifolds.clear();
+}
+
+bool ContactSolver::AddContact(Entity& first, Entity& second, float restitution)
+{
+	Manifold manifold{ &first, &second, sf::FloatRect(), {}, 0.f, restitution, false };
+	if (!FindContact(first.GetBoundingRect(), second.GetBoundingRect(), manifold.normal, manifold.depth))
+		return false;
+
+	m_manifolds.push_back(manifold);
+	return true;
+}
+
+bool ContactSolver::AddContact(Entity& body, const sf::FloatRect& solid)
+{
+	Manifold manifold{ &body, nullptr, solid, {}, 0.f, 0.f, false };
+	if (!FindContact(body.GetBoundingRect(), solid, manifold.normal, manifold.depth))
+		return false;
+
+	m_manifolds.push_back(manifold);
+	return true;
+}
+
+void ContactSolver::Solve()
+{
+	for (Manifold& manifold : m_manifolds)
+	{
+		const sf::Vector2f second_velocity = manifold.second ? manifold.second->GetVelocity() : sf::Vector2f();
+		manifold.approaching = Dot(manifold.first->GetVelocity() - second_velocity, manifold.normal) <= 0.f;
+	}
+
+	//Velocities first so bodies stop closing in, then the overlap left over is pushed out
+	for (int i = 0; i < kIterations; ++i)
+	{
+		for (Manifold& manifold : m_manifolds)
+		{
+			SolveVelocity(manifold);
+		}
+	}
+	for (int i = 0; i < kIterations; ++i)
+	{
+		for (const Manifold& manifold : m_manifolds)
+		{
+			SolvePosition(manifold);
+		}
+	}
+}
+
+const std::vector<ContactSolver::Manifold>& ContactSolver::GetManifolds() const
+{
+	return m_manifolds;
+}
+
+void ContactSolver::SolveVelocity(Manifold& manifold) const
+{
+	const float first_inverse_mass = GetInverseMass(manifold.first);
+	const float second_inverse_mass = GetInverseMass(manifold.second);
+
+	const sf::Vector2f first_velocity = manifold.first->GetVelocity();
+	const sf::Vector2f second_velocity = manifold.second ? manifold.second->GetVelocity() : sf::Vector2f();
+	const float closing_speed = Dot(first_velocity - second_velocity, manifold.normal);
+	if (closing_speed >= 0.f)
+		return;
+
+	const float restitution = closing_speed < -kBounceSpeed ? manifold.restitution : 0.f;
+	const float impulse = -(1.f + restitution) * closing_speed / (first_inverse_mass + second_inverse_mass);
+	manifold.first->SetVelocity(first_velocity + manifold.normal * (impulse * first_inverse_mass));
+	if (manifold.second)
+	{
+		manifold.second->SetVelocity(second_velocity - manifold.normal * (impulse * second_inverse_mass));
+	}
+}
+
+void ContactSolver::SolvePosition(const Manifold& manifold) const
+{
+	//Measured again along the contact's own axis, earlier contacts may already have moved either body
+	const sf::FloatRect first_rect = manifold.first->GetBoundingRect();
+	const sf::FloatRect second_rect = manifold.second ? manifold.second->GetBoundingRect() : manifold.solid;
+	const sf::Vector2f half_sum = (first_rect.size + second_rect.size) * 0.5f;
+	const float reach = std::abs(manifold.normal.x) * half_sum.x + std::abs(manifold.normal.y) * half_sum.y;
+	const float depth = reach - Dot(GetCenter(first_rect) - GetCenter(second_rect), manifold.normal);
+	if (depth <= 0.f)
+		return;
+
+	const float first_inverse_mass = GetInverseMass(manifold.first);
+	const float second_inverse_mass = GetInverseMass(manifold.second);
+	const float total_inverse_mass = first_inverse_mass + second_inverse_mass;
+	manifold.first->move(manifold.normal * (depth * first_inverse_mass / total_inverse_mass));
+	if (manifold.second)
+	{
+		manifold.second->move(-manifold.normal * (depth * second_inverse_mass / total_inverse_mass));
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+class Entity;
+
+//Every overlap between players, boxes and platforms found in a tick is gathered first and then resolved together
+//Velocities and positions are relaxed over a few passes, so a stack of boxes settles the same whatever order its pairs were found in
+class ContactSolver
+{
+public:
+	//One overlap, normal is the separating axis pointing from second towards first
+	struct Manifold
+	{
+		Entity* first;
+		//Null against a static solid, which never moves
+		Entity* second;
+		sf::FloatRect solid;
+		sf::Vector2f normal;
+		float depth;
+		float restitution;
+		//The bodies were moving into each other before the solve, a body on top of such a contact has landed
+		bool approaching;
+	};
+
+	static const int kIterations = 4;
+	//Slower contacts than this don't bounce, otherwise a body resting on a bouncy one never comes to rest
+	static constexpr float kBounceSpeed = 60.f;
+
+	//Axis of least overlap between two rects, false if they don't overlap
+	static bool FindContact(const sf::FloatRect& first, const sf::FloatRect& second, sf::Vector2f& normal, float& depth);
+	//Swept test of first moving by motion against a still second, time is the fraction of motion covered before they touch
+	//False if they never touch during the motion, or already overlap at its start which FindContact deals with
+	static bool FindTimeOfImpact(const sf::FloatRect& first, sf::Vector2f motion, const sf::FloatRect& second, float& time, sf::Vector2f& normal);
+
+	void Clear();
+	//Both return false when the bodies don't actually overlap, then nothing is added
+	bool AddContact(Entity& first, Entity& second, float restitution);
+	bool AddContact(Entity& body, const sf::FloatRect& solid);
+	//Separation is shared out by inverse mass from Entity::GetMass
+	void Solve();
+	const std::vector<Manifold>& GetManifolds() const;
+
+private:
+	void SolveVelocity(Manifold& manifold) const;
+	void SolvePosition(const Manifold& manifold) const;
+
+private:
+	std::vector<Manifold> m_manifolds;
+};
@@ -8,12 +8,15 @@ Entity::Entity(int hitpoints)
 void Entity::SetVelocity(sf::Vector2f velocity)
 {
     m_velocity = velocity;
+    if (velocity != sf::Vector2f())
+    {
+        WakeUp();
+    }
 }
 
 void Entity::SetVelocity(float vx, float vy)
 {
-    m_velocity.x = vx;
-    m_velocity.y = vy;
+    SetVelocity({ vx, vy });
 }
 
 sf::Vector2f Entity::GetVelocity() const
@@ -50,11 +53,13 @@ float Entity::GetMass() const
 
 void Entity::AddForce(sf::Vector2f force)
 {
+    WakeUp();
     m_accumulated_forces += force;
 }
 
 void Entity::AddImpulse(sf::Vector2f impulse)
 {
+    WakeUp();
     //Impulse changes velocity directly
     m_velocity += impulse / m_mass;
 }
@@ -108,6 +113,21 @@ bool Entity::IsDestroyed() const
     return m_hitpoints <= 0;
 }
 
+void Entity::SetHitPoints(int hitpoints)
+{
+    m_hitpoints = hitpoints;
+}
+
+void Entity::SetNetworkId(std::uint32_t network_id)
+{
+    m_network_id = network_id;
+}
+
+std::uint32_t Entity::GetNetworkId() const
+{
+    return m_network_id;
+}
+
 void Entity::ApplyPhysics(sf::Time dt)
 {
     const float seconds = dt.asSeconds();
@@ -133,6 +153,7 @@ void Entity::ApplyPhysics(sf::Time dt)
 
 void Entity::ApplyKnockback(sf::Vector2f velocity, sf::Time duration)
 {
+    WakeUp();
     m_knockback_velocity = velocity;
     m_knockback_duration = duration;
 
@@ -160,7 +181,74 @@ void Entity::ClearKnockback()
     m_knockback_duration = sf::Time::Zero;
 }
 
+void Entity::SetCanSleep(bool can_sleep)
+{
+    m_can_sleep = can_sleep;
+    if (!can_sleep)
+    {
+        WakeUp();
+    }
+}
+
+bool Entity::IsAsleep() const
+{
+    return m_is_asleep;
+}
+
+bool Entity::IsAtRest() const
+{
+    return m_is_asleep || m_rest_ticks > 0;
+}
+
+void Entity::WakeUp()
+{
+    //Awake bodies keep counting, gravity is added every tick and must not reset the count
+    if (!m_is_asleep)
+        return;
+
+    m_is_asleep = false;
+    m_rest_ticks = 0;
+}
+
+void Entity::UpdateSleep()
+{
+    if (!m_can_sleep || m_is_asleep)
+        return;
+
+    const bool resting = !IsKnockbackActive()
+        && m_velocity.x * m_velocity.x + m_velocity.y * m_velocity.y < kSleepSpeed * kSleepSpeed;
+    m_rest_ticks = resting ? m_rest_ticks + 1 : 0;
+    if (m_rest_ticks < kSleepTicks)
+        return;
+
+    m_is_asleep = true;
+    m_velocity = { 0.f, 0.f };
+    m_accumulated_forces = { 0.f, 0.f };
+}
+
+void Entity::SetLocallyPredicted(bool predicted)
+{
+    m_is_locally_predicted = predicted;
+}
+
+bool Entity::IsLocallyPredicted() const
+{
+    return m_is_locally_predicted;
+}
+
 void Entity::UpdateCurrent(sf::Time dt, CommandQueue& commands)
+{
+    if (m_is_locally_predicted)
+        return;
+
+    UpdateSleep();
+    if (!m_is_asleep)
+    {
+        IntegrateMotion(dt);
+    }
+}
+
+void Entity::IntegrateMotion(sf::Time dt)
 {
 	ApplyPhysics(dt);
 
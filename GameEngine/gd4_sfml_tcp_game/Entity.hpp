@@ -1,10 +1,15 @@
 #pragma once
 #include "SceneNode.hpp"
 #include "CommandQueue.hpp"
+#include <cstdint>
 
 class Entity : public SceneNode
 {
 public:
+	//A body slower than kSleepSpeed for kSleepTicks updates in a row goes to sleep
+	static constexpr float kSleepSpeed = 30.f;
+	static const int kSleepTicks = 30;
+
 	Entity(int hitpoints);
 	void SetVelocity(sf::Vector2f velocity);
 	void SetVelocity(float vx, float vy);
@@ -33,11 +38,31 @@ public:
 	sf::Time GetRemainingKnockbackDuration() const;
 	void ClearKnockback();
 
+	//Sleeping
+	//A sleeping body skips gravity, integration and its tests against static solids until a force, impulse, knockback or contact wakes it
+	void SetCanSleep(bool can_sleep);
+	virtual bool IsAsleep() const override;
+	//Asleep, or slower than kSleepSpeed at its last update and on its way to sleep
+	bool IsAtRest() const;
+	void WakeUp();
+
 	int GetHitPoints() const;
 	void Repair(int points);
 	virtual void Damage(int points);
 	void Destroy();
 	virtual bool IsDestroyed() const override;
+	//Replicas take their hitpoints straight from the server
+	void SetHitPoints(int hitpoints);
+
+	//Identifies the entity in network snapshots, 0 until the World registers it
+	void SetNetworkId(std::uint32_t network_id);
+	std::uint32_t GetNetworkId() const;
+
+	//One step of forces, drag, knockback and velocity, UpdateCurrent runs it unless the entity is locally predicted
+	void IntegrateMotion(sf::Time dt);
+	//A predicted entity is moved by the client's prediction instead of the scene update
+	void SetLocallyPredicted(bool predicted);
+	bool IsLocallyPredicted() const;
 
 	virtual void UpdateCurrent(sf::Time dt, CommandQueue& commands);
 
@@ -45,6 +70,9 @@ protected:
 	//Helper for integrating physics
 	virtual void ApplyPhysics(sf::Time dt);
 
+private:
+	void UpdateSleep();
+
 private:
 	sf::Vector2f m_velocity;
 	int m_hitpoints;
@@ -56,5 +84,12 @@ private:
 
 	sf::Vector2f m_knockback_velocity{ 0.f, 0.f };
 	sf::Time m_knockback_duration{ sf::Time::Zero };
+
+	bool m_can_sleep = false;
+	bool m_is_asleep = false;
+	int m_rest_ticks = 0;
+
+	std::uint32_t m_network_id = 0;
+	bool m_is_locally_predicted = false;
 };
 
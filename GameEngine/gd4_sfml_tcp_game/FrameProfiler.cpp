@@ -0,0 +1,143 @@
+#include "FrameProfiler.hpp"
+#include <algorithm>
+#include <cassert>
+
+FrameProfiler::FrameProfiler()
+	: m_phase_totals()
+	, m_frame_total(0)
+	, m_frame_count(0)
+	, m_frame_start()
+	, m_current_frame()
+	, m_history()
+	, m_history_next(0)
+	, m_history_count(0)
+{
+}
+
+void FrameProfiler::BeginFrame()
+{
+	m_current_frame.fill(0);
+	m_frame_start = std::chrono::steady_clock::now();
+}
+
+void FrameProfiler::EndFrame()
+{
+	std::int64_t frame_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_frame_start).count();
+	m_frame_total += frame_time;
+	++m_frame_count;
+
+	m_current_frame[static_cast<int>(ProfilePhase::kPhaseCount)] = frame_time;
+	m_history[m_history_next] = m_current_frame;
+	m_history_next = (m_history_next + 1) % kHistorySize;
+	if (m_history_count < kHistorySize)
+	{
+		++m_history_count;
+	}
+}
+
+void FrameProfiler::AddSample(ProfilePhase phase, std::chrono::nanoseconds duration)
+{
+	assert(phase != ProfilePhase::kPhaseCount);
+	m_phase_totals[static_cast<int>(phase)] += duration.count();
+	m_current_frame[static_cast<int>(phase)] += duration.count();
+}
+
+void FrameProfiler::Reset()
+{
+	m_phase_totals.fill(0);
+	m_frame_total = 0;
+	m_frame_count = 0;
+	m_current_frame.fill(0);
+	m_history_next = 0;
+	m_history_count = 0;
+}
+
+std::uint64_t FrameProfiler::GetFrameCount() const
+{
+	return m_frame_count;
+}
+
+std::int64_t FrameProfiler::GetTotalNanoseconds() const
+{
+	return m_frame_total;
+}
+
+std::int64_t FrameProfiler::GetPhaseNanoseconds(ProfilePhase phase) const
+{
+	return m_phase_totals[static_cast<int>(phase)];
+}
+
+std::int64_t FrameProfiler::GetRollingAverageNanoseconds(ProfilePhase phase) const
+{
+	if (m_history_count == 0)
+		return 0;
+
+	std::int64_t total = 0;
+	for (int i = 0; i < m_history_count; ++i)
+	{
+		total += m_history[i][static_cast<int>(phase)];
+	}
+	return total / m_history_count;
+}
+
+std::int64_t FrameProfiler::GetRollingWorstNanoseconds(ProfilePhase phase) const
+{
+	std::int64_t worst = 0;
+	for (int i = 0; i < m_history_count; ++i)
+	{
+		worst = std::max(worst, m_history[i][static_cast<int>(phase)]);
+	}
+	return worst;
+}
+
+const char* FrameProfiler::GetPhaseName(ProfilePhase phase)
+{
+	switch (phase)
+	{
+	case ProfilePhase::kForces:
+		return "Forces";
+	case ProfilePhase::kCommands:
+		return "Commands";
+	case ProfilePhase::kSceneUpdate:
+		return "SceneUpdate";
+	case ProfilePhase::kPlayerAdapt:
+		return "PlayerAdapt";
+	case ProfilePhase::kCollisions:
+		return "Collisions";
+	case ProfilePhase::kCleanup:
+		return "Cleanup";
+	case ProfilePhase::kLateCommands:
+		return "LateCommands";
+	case ProfilePhase::kRoundLogic:
+		return "RoundLogic";
+	case ProfilePhase::kSceneDraw:
+		return "SceneDraw";
+	case ProfilePhase::kPostEffects:
+		return "PostEffects";
+	case ProfilePhase::kOverlayDraw:
+		return "OverlayDraw";
+	case ProfilePhase::kPhaseCount:
+		return "Frame";
+	default:
+		return "Unknown";
+	}
+}
+
+ScopedPhaseTimer::ScopedPhaseTimer(FrameProfiler* profiler, ProfilePhase phase)
+	: m_profiler(profiler)
+	, m_phase(phase)
+	, m_trace_event(FrameProfiler::GetPhaseName(phase))
+{
+	if (m_profiler)
+	{
+		m_start = std::chrono::steady_clock::now();
+	}
+}
+
+ScopedPhaseTimer::~ScopedPhaseTimer()
+{
+	if (m_profiler)
+	{
+		m_profiler->AddSample(m_phase, std::chrono::steady_clock::now() - m_start);
+	}
+}
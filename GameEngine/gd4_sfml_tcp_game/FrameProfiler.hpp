@@ -0,0 +1,80 @@
+#pragma once
+#include "TraceRecorder.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+enum class ProfilePhase
+{
+	kForces,
+	kCommands,
+	kSceneUpdate,
+	kPlayerAdapt,
+	kCollisions,
+	kCleanup,
+	kLateCommands,
+	kRoundLogic,
+	kSceneDraw,
+	kPostEffects,
+	kOverlayDraw,
+	kPhaseCount
+};
+
+//Accumulates how long each phase of World::Update and World::Draw takes across frames
+//The last kHistorySize frames are also kept so the overlay can show rolling averages and the worst frame
+class FrameProfiler
+{
+public:
+	static const int kHistorySize = 120;
+
+public:
+	FrameProfiler();
+
+	void BeginFrame();
+	void EndFrame();
+	void AddSample(ProfilePhase phase, std::chrono::nanoseconds duration);
+	void Reset();
+
+	std::uint64_t GetFrameCount() const;
+	std::int64_t GetTotalNanoseconds() const;
+	std::int64_t GetPhaseNanoseconds(ProfilePhase phase) const;
+
+	//Over the frames in the rolling history, kPhaseCount stands for the whole frame
+	std::int64_t GetRollingAverageNanoseconds(ProfilePhase phase) const;
+	std::int64_t GetRollingWorstNanoseconds(ProfilePhase phase) const;
+
+	static const char* GetPhaseName(ProfilePhase phase);
+
+private:
+	//One slot per phase plus the whole frame in the last slot
+	typedef std::array<std::int64_t, static_cast<int>(ProfilePhase::kPhaseCount) + 1> FrameSample;
+
+private:
+	std::array<std::int64_t, static_cast<int>(ProfilePhase::kPhaseCount)> m_phase_totals;
+	std::int64_t m_frame_total;
+	std::uint64_t m_frame_count;
+	std::chrono::steady_clock::time_point m_frame_start;
+
+	FrameSample m_current_frame;
+	std::array<FrameSample, kHistorySize> m_history;
+	int m_history_next;
+	int m_history_count;
+};
+
+//Adds the time between construction and destruction to a phase, does nothing without a profiler
+//The phase is also emitted as a trace event while the TraceRecorder is recording
+class ScopedPhaseTimer
+{
+public:
+	ScopedPhaseTimer(FrameProfiler* profiler, ProfilePhase phase);
+	~ScopedPhaseTimer();
+
+	ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+	ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+private:
+	FrameProfiler* m_profiler;
+	ProfilePhase m_phase;
+	std::chrono::steady_clock::time_point m_start;
+	ScopedTraceEvent m_trace_event;
+};
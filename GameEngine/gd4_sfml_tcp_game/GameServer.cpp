@@ -0,0 +1,727 @@
+#include "GameServer.hpp"
+#include "PacketType.hpp"
+#include "SnapshotCodec.hpp"
+#include "TraceRecorder.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <SFML/System/Sleep.hpp>
+
+const sf::Time GameServer::kTimePerTick = sf::seconds(1.f / NetworkConfig::kTicksPerSecond);
+const sf::Time GameServer::kClientTimeout = sf::seconds(5.f);
+//Same catch-up cap as the client, a server that falls further behind than this drops the backlog
+const int GameServer::kMaxTicksPerFrame = 5;
+//Longest a queued datagram waits for the I/O thread when nothing arrives to wake it
+const sf::Time GameServer::kIoPollInterval = sf::milliseconds(1);
+
+namespace
+{
+	//A second of inputs from every seat, or of everything else from every client, before the I/O thread starts dropping
+	std::size_t GetQueueCapacity(int match_count)
+	{
+		return static_cast<std::size_t>(std::max(1, match_count) * ServerMatch::kMaxPlayers * NetworkConfig::kTicksPerSecond);
+	}
+
+	//A snapshot and a batch per client in flight at once, the pool grows past this if the I/O thread falls behind
+	std::size_t GetPacketPoolSize(int match_count)
+	{
+		return static_cast<std::size_t>(std::max(1, match_count) * ServerMatch::kMaxPlayers * 2);
+	}
+}
+
+GameServer::ClientSlot::ClientSlot()
+	: connected(false)
+	, session(0)
+	, address()
+	, port(0)
+	, last_heard(sf::Time::Zero)
+	, has_acked_snapshot(false)
+	, acked_snapshot_tick(0)
+	, channel()
+	, batch()
+{
+}
+
+GameServer::InputMessage::InputMessage()
+	: slot(0)
+	, session(0)
+	, received(sf::Time::Zero)
+	, has_snapshot(false)
+	, acked_snapshot_tick(0)
+	, inputs()
+	, input_count(0)
+{
+}
+
+GameServer::InboundDatagram::InboundDatagram()
+	: type(PacketType::kJoinRequest)
+	, slot(-1)
+	, session(0)
+	, address()
+	, port(0)
+	, packet()
+{
+}
+
+GameServer::OutboundDatagram::OutboundDatagram()
+	: kind(Kind::kDatagram)
+	, slot(-1)
+	, session(0)
+	, address()
+	, port(0)
+	, packet()
+{
+}
+
+GameServer::HostedMatch::HostedMatch()
+	: match()
+	, snapshot()
+	, snapshot_history()
+	, round_events()
+	, inputs()
+	, tick_duration(sf::Time::Zero)
+	, overruns_since_report(0)
+	, worst_since_report(sf::Time::Zero)
+	, total_overruns(0)
+{
+}
+
+GameServer::GameServer(unsigned short port, int match_count, int worker_count)
+	: m_port(port)
+	, m_running(false)
+	, m_link(m_socket)
+	, m_io_running(false)
+	, m_packets(GetPacketPoolSize(match_count), PacketBatch::kMaxDatagramSize)
+	, m_inbound(GetQueueCapacity(match_count))
+	, m_outbound(GetQueueCapacity(match_count))
+	, m_clients(std::max(1, match_count) * ServerMatch::kMaxPlayers)
+	, m_matches(std::max(1, match_count))
+	, m_pool(worker_count)
+	, m_next_seed(std::random_device{}())
+	, m_next_session(0)
+	, m_tick_start(sf::Time::Zero)
+	, m_ticks_since_report(0)
+	, m_ticks_since_snapshot(0)
+{
+	for (int i = 0; i < static_cast<int>(m_matches.size()); ++i)
+	{
+		m_matches[i].match = std::make_unique<ServerMatch>(m_next_seed++);
+		m_matches[i].inputs = std::make_unique<SpscQueue<InputMessage>>(static_cast<std::size_t>(ServerMatch::kMaxPlayers * NetworkConfig::kTicksPerSecond));
+	}
+}
+
+bool GameServer::Run()
+{
+	if (m_socket.bind(m_port) != sf::Socket::Status::Done)
+	{
+		std::cout << "[SERVER] Could not bind UDP port " << m_port << std::endl;
+		return false;
+	}
+	m_socket.setBlocking(false);
+	m_selector.add(m_socket);
+	m_link.SetConditions(NetworkConfig::GetInstance().GetConditions());
+	std::cout << "[SERVER] Listening on UDP port " << m_port << ", hosting " << m_matches.size() << " matches on "
+		<< m_pool.GetThreadCount() << " threads" << std::endl;
+
+	m_running = true;
+	m_io_running = true;
+	m_io_thread = std::thread(&GameServer::IoLoop, this);
+
+	sf::Time time_since_last_tick = sf::Time::Zero;
+	sf::Time last_time = m_clock.getElapsedTime();
+	while (m_running)
+	{
+		sf::Time now = m_clock.getElapsedTime();
+		time_since_last_tick += now - last_time;
+		last_time = now;
+
+		int ticks = 0;
+		while (time_since_last_tick >= kTimePerTick && ticks < kMaxTicksPerFrame)
+		{
+			time_since_last_tick -= kTimePerTick;
+			++ticks;
+			HandleInbound();
+			//The tick was due when the accumulator crossed it, time spent catching up counts against its deadline
+			m_tick_start = m_clock.getElapsedTime() - time_since_last_tick;
+			Tick();
+		}
+
+		if (time_since_last_tick >= kTimePerTick)
+		{
+			time_since_last_tick = sf::seconds(std::fmod(time_since_last_tick.asSeconds(), kTimePerTick.asSeconds()));
+		}
+
+		//Nothing to wait on here any more, datagrams pile up in the queues until the next tick takes them
+		sf::sleep(kTimePerTick - time_since_last_tick);
+	}
+
+	//Tell everyone the server is going away rather than letting them time out, the I/O thread sends it all before stopping
+	for (int i = 0; i < static_cast<int>(m_clients.size()); ++i)
+	{
+		DisconnectClient(i, true);
+	}
+	m_io_running = false;
+	m_io_thread.join();
+
+	m_link.PrintStatistics("SERVER");
+	PrintOverrunTotals();
+	m_selector.clear();
+	m_socket.unbind();
+	return true;
+}
+
+void GameServer::Stop()
+{
+	m_running = false;
+}
+
+void GameServer::IoLoop()
+{
+	while (m_io_running)
+	{
+		//Wakes as soon as a datagram arrives, the short timeout bounds how long queued sends wait. A zero timeout would wait forever
+		sf::Time wait_time = kIoPollInterval;
+		if (std::optional<sf::Time> delivery = m_link.GetTimeUntilNextDelivery())
+		{
+			wait_time = std::min(wait_time, *delivery);
+		}
+		if (wait_time > sf::Time::Zero)
+		{
+			static_cast<void>(m_selector.wait(wait_time));
+		}
+		ReceiveDatagrams();
+		SendQueued();
+		m_link.Update();
+	}
+
+	//Goodbyes queued during shutdown
+	SendQueued();
+	m_link.Flush();
+}
+
+void GameServer::ReceiveDatagrams()
+{
+	sf::Packet packet;
+	std::optional<sf::IpAddress> address;
+	unsigned short port = 0;
+	while (m_link.Receive(packet, address, port) == sf::Socket::Status::Done)
+	{
+		if (address)
+		{
+			RouteDatagram(packet, *address, port);
+		}
+	}
+}
+
+void GameServer::RouteDatagram(sf::Packet& packet, const sf::IpAddress& address, unsigned short port)
+{
+	std::uint8_t type = 0;
+	if (!(packet >> type))
+		return;
+
+	//Everything but a join request is only accepted from a client that has joined
+	const auto endpoint = m_endpoints.find(GetEndpointKey(address, port));
+	if (endpoint == m_endpoints.end() && static_cast<PacketType>(type) != PacketType::kJoinRequest)
+		return;
+
+	//A full queue means the server is too far behind to use it anyway, so it is dropped like a lost datagram
+	if (static_cast<PacketType>(type) == PacketType::kInput)
+	{
+		InputMessage message;
+		message.slot = endpoint->second.slot;
+		message.session = endpoint->second.session;
+		message.received = m_clock.getElapsedTime();
+		packet >> message.has_snapshot >> message.acked_snapshot_tick;
+		BitReader reader(packet);
+		if (packet && InputCodec::Read(reader, message.inputs.data(), message.input_count))
+		{
+			static_cast<void>(m_matches[message.slot / ServerMatch::kMaxPlayers].inputs->TryPush(message));
+		}
+		return;
+	}
+
+	InboundDatagram datagram;
+	datagram.type = static_cast<PacketType>(type);
+	if (endpoint != m_endpoints.end())
+	{
+		datagram.slot = endpoint->second.slot;
+		datagram.session = endpoint->second.session;
+	}
+	datagram.address = address;
+	datagram.port = port;
+	datagram.packet = std::move(packet);
+	static_cast<void>(m_inbound.TryPush(std::move(datagram)));
+}
+
+void GameServer::SendQueued()
+{
+	OutboundDatagram datagram;
+	while (m_outbound.TryPop(datagram))
+	{
+		switch (datagram.kind)
+		{
+		case OutboundDatagram::Kind::kDatagram:
+			//UDP gives no delivery guarantee anyway, a datagram the OS refuses is treated like one lost on the wire
+			static_cast<void>(m_link.Send(*datagram.packet, *datagram.address, datagram.port));
+			//Back to the pool as soon as the last client sharing it has been sent it
+			datagram.packet = PooledPacket();
+			break;
+		case OutboundDatagram::Kind::kBind:
+			m_endpoints[GetEndpointKey(*datagram.address, datagram.port)] = Endpoint{ datagram.slot, datagram.session };
+			break;
+		case OutboundDatagram::Kind::kUnbind:
+			m_endpoints.erase(GetEndpointKey(*datagram.address, datagram.port));
+			break;
+		}
+	}
+}
+
+void GameServer::HandleInbound()
+{
+	InboundDatagram datagram;
+	while (m_inbound.TryPop(datagram))
+	{
+		HandlePacket(datagram);
+	}
+}
+
+void GameServer::HandlePacket(InboundDatagram& datagram)
+{
+	if (datagram.type == PacketType::kJoinRequest)
+	{
+		HandleJoinRequest(datagram);
+		return;
+	}
+
+	//Queued before the slot changed hands
+	const int slot = datagram.slot;
+	if (slot < 0 || !m_clients[slot].connected || m_clients[slot].session != datagram.session)
+		return;
+	m_clients[slot].last_heard = m_clock.getElapsedTime();
+
+	switch (datagram.type)
+	{
+	case PacketType::kReliable:
+		//Clients only acknowledge, they have no events of their own to send
+		static_cast<void>(m_clients[slot].channel.Read(datagram.packet, m_clock.getElapsedTime()));
+		break;
+	case PacketType::kLeave:
+		std::cout << "[SERVER] Player " << (slot % ServerMatch::kMaxPlayers + 1) << " left match " << (slot / ServerMatch::kMaxPlayers + 1) << std::endl;
+		DisconnectClient(slot, false);
+		break;
+	default:
+		break;
+	}
+}
+
+void GameServer::HandleJoinRequest(InboundDatagram& datagram)
+{
+	std::uint16_t version = 0;
+	datagram.packet >> version;
+	const sf::IpAddress& address = *datagram.address;
+	const unsigned short port = datagram.port;
+
+	//A repeated request means our accept was lost, answer it again with the same slot
+	int slot = FindClient(address, port);
+	if (slot < 0 && version == NetworkConfig::kProtocolVersion)
+	{
+		for (int i = 0; i < static_cast<int>(m_clients.size()); ++i)
+		{
+			if (!m_clients[i].connected)
+			{
+				slot = i;
+				m_clients[i].connected = true;
+				m_clients[i].session = ++m_next_session;
+				m_clients[i].address = address;
+				m_clients[i].port = port;
+				PushEndpointChange(OutboundDatagram::Kind::kBind, i);
+				m_matches[i / ServerMatch::kMaxPlayers].match->ResetPlayer(i % ServerMatch::kMaxPlayers);
+				std::cout << "[SERVER] Player " << (slot % ServerMatch::kMaxPlayers + 1) << " joined match " << (slot / ServerMatch::kMaxPlayers + 1)
+					<< " from " << address << ":" << port << std::endl;
+
+				//Whatever the match has already been through, the joining client starts from the same round and scores
+				sf::Packet state;
+				state << m_matches[slot / ServerMatch::kMaxPlayers].match->CaptureRoundState();
+				m_clients[i].channel.Send(state);
+				break;
+			}
+		}
+	}
+
+	PooledPacket reply = m_packets.Acquire();
+	if (slot < 0)
+	{
+		*reply << static_cast<std::uint8_t>(PacketType::kJoinRejected);
+	}
+	else
+	{
+		m_clients[slot].last_heard = m_clock.getElapsedTime();
+		*reply << static_cast<std::uint8_t>(PacketType::kJoinAccepted) << static_cast<std::uint8_t>(slot % ServerMatch::kMaxPlayers);
+	}
+	Send(reply, address, port);
+}
+
+void GameServer::Tick()
+{
+	ScopedTraceEvent trace("GameServer::Tick");
+	DropTimedOutClients();
+
+	//Matches share nothing, so they step in parallel. The sockets, clients and channels are only touched on this thread
+	m_pool.Run(static_cast<int>(m_matches.size()), [this](int match)
+		{
+			StepMatch(match);
+		});
+
+	for (int i = 0; i < static_cast<int>(m_matches.size()); ++i)
+	{
+		FinishMatchTick(i);
+	}
+
+	if (++m_ticks_since_report >= NetworkConfig::kTicksPerSecond)
+	{
+		m_ticks_since_report = 0;
+		ReportOverruns();
+	}
+
+	//Resends and acks go out every tick, not only with snapshots, so a lost event is retried as soon as it is due
+	//They are queued first so a snapshot sent this tick can share their datagram
+	for (int i = 0; i < static_cast<int>(m_clients.size()); ++i)
+	{
+		SendReliable(i);
+	}
+
+	//Counted separately from the match ticks, which stand still until both seats are taken
+	++m_ticks_since_snapshot;
+	if (m_ticks_since_snapshot >= NetworkConfig::kSnapshotInterval)
+	{
+		m_ticks_since_snapshot = 0;
+		for (int i = 0; i < static_cast<int>(m_matches.size()); ++i)
+		{
+			BroadcastSnapshot(i);
+		}
+	}
+
+	for (int i = 0; i < static_cast<int>(m_clients.size()); ++i)
+	{
+		FlushBatch(i);
+	}
+}
+
+void GameServer::StepMatch(int match)
+{
+	HostedMatch& hosted = m_matches[match];
+	TakeInputs(match);
+
+	//A match only runs with every seat taken, until then clients see the start of the round
+	if (CountConnectedClients(match) < ServerMatch::kMaxPlayers)
+		return;
+
+	hosted.match->Update(kTimePerTick);
+	hosted.match->TakeRoundEvents(hosted.round_events);
+
+	hosted.tick_duration = m_clock.getElapsedTime() - m_tick_start;
+	if (hosted.tick_duration > kTimePerTick)
+	{
+		++hosted.overruns_since_report;
+		++hosted.total_overruns;
+		hosted.worst_since_report = std::max(hosted.worst_since_report, hosted.tick_duration);
+	}
+}
+
+void GameServer::TakeInputs(int match)
+{
+	HostedMatch& hosted = m_matches[match];
+	InputMessage message;
+	while (hosted.inputs->TryPop(message))
+	{
+		ClientSlot& client = m_clients[message.slot];
+		if (!client.connected || client.session != message.session)
+			continue;
+
+		client.last_heard = std::max(client.last_heard, message.received);
+		if (message.has_snapshot && (!client.has_acked_snapshot || message.acked_snapshot_tick > client.acked_snapshot_tick))
+		{
+			client.has_acked_snapshot = true;
+			client.acked_snapshot_tick = message.acked_snapshot_tick;
+		}
+		for (int i = 0; i < message.input_count; ++i)
+		{
+			hosted.match->SubmitInput(message.slot % ServerMatch::kMaxPlayers, message.inputs[i]);
+		}
+	}
+}
+
+void GameServer::FinishMatchTick(int match)
+{
+	HostedMatch& hosted = m_matches[match];
+	BroadcastRoundEvents(match);
+
+	const int first_slot = match * ServerMatch::kMaxPlayers;
+	if (hosted.match->IsFinished())
+	{
+		std::cout << "[SERVER] Match " << (match + 1) << " finished" << std::endl;
+		for (int i = first_slot; i < first_slot + ServerMatch::kMaxPlayers; ++i)
+		{
+			DisconnectClient(i, true);
+		}
+	}
+
+	//Once everyone has gone a match that has started is thrown away so the next players get a fresh one
+	if (CountConnectedClients(match) == 0 && hosted.match->GetTick() > 0)
+	{
+		ResetMatch(match);
+	}
+}
+
+void GameServer::ResetMatch(int match)
+{
+	HostedMatch& hosted = m_matches[match];
+	hosted.match = std::make_unique<ServerMatch>(m_next_seed++);
+	hosted.snapshot_history.Clear();
+	hosted.round_events.clear();
+}
+
+void GameServer::BroadcastSnapshot(int match)
+{
+	HostedMatch& hosted = m_matches[match];
+	const std::uint8_t connected = static_cast<std::uint8_t>(CountConnectedClients(match));
+	if (connected == 0)
+		return;
+
+	//Kept exactly as clients will decode it, so it can serve as their baseline later
+	WorldSnapshot& snapshot = hosted.snapshot;
+	hosted.match->CaptureSnapshot(snapshot);
+	SnapshotCodec::Quantize(snapshot);
+	hosted.snapshot_history.Store(snapshot);
+
+	//Clients acknowledging the same snapshot are sent the very same bytes, encoded once and shared rather than copied
+	std::array<PooledPacket, ServerMatch::kMaxPlayers> encoded;
+	std::array<std::uint32_t, ServerMatch::kMaxPlayers> encoded_age{};
+	int encoded_count = 0;
+
+	for (int player = 0; player < ServerMatch::kMaxPlayers; ++player)
+	{
+		const int slot = match * ServerMatch::kMaxPlayers + player;
+		ClientSlot& client = m_clients[slot];
+		if (!client.connected)
+			continue;
+
+		//Each client gets a delta against the newest snapshot it has told us about, or a full one
+		const WorldSnapshot* baseline = nullptr;
+		std::uint32_t baseline_age = 0;
+		if (client.has_acked_snapshot && client.acked_snapshot_tick < snapshot.tick)
+		{
+			baseline_age = snapshot.tick - client.acked_snapshot_tick;
+			baseline = baseline_age < SnapshotHistory::kCapacity ? hosted.snapshot_history.Find(client.acked_snapshot_tick) : nullptr;
+		}
+		if (!baseline)
+		{
+			baseline_age = 0;
+		}
+
+		PooledPacket packet;
+		for (int i = 0; i < encoded_count && !packet; ++i)
+		{
+			if (encoded_age[i] == baseline_age)
+			{
+				packet = encoded[i];
+			}
+		}
+
+		if (!packet)
+		{
+			m_bit_writer.Clear();
+			SnapshotCodec::Write(m_bit_writer, snapshot, baseline);
+
+			packet = m_packets.Acquire();
+			*packet << static_cast<std::uint8_t>(PacketType::kSnapshot) << connected << snapshot.tick << static_cast<std::uint8_t>(baseline_age);
+			for (int i = 0; i < ServerMatch::kMaxPlayers; ++i)
+			{
+				*packet << hosted.match->GetLastInputTick(i);
+			}
+			m_bit_writer.AppendTo(*packet);
+			encoded[encoded_count] = packet;
+			encoded_age[encoded_count] = baseline_age;
+			++encoded_count;
+		}
+
+		//Only a client with reliable traffic waiting gets its own copy, batched with that traffic. Everyone else is sent the shared bytes
+		if (client.batch.IsEmpty() || !client.batch.Add(*packet))
+		{
+			Send(packet, *client.address, client.port);
+		}
+	}
+}
+
+void GameServer::BroadcastRoundEvents(int match)
+{
+	HostedMatch& hosted = m_matches[match];
+	for (const RoundEvent& event : hosted.round_events)
+	{
+		sf::Packet message;
+		message << event;
+		for (int i = match * ServerMatch::kMaxPlayers; i < (match + 1) * ServerMatch::kMaxPlayers; ++i)
+		{
+			if (m_clients[i].connected)
+			{
+				m_clients[i].channel.Send(message);
+			}
+		}
+	}
+	hosted.round_events.clear();
+}
+
+void GameServer::ReportOverruns()
+{
+	for (int i = 0; i < static_cast<int>(m_matches.size()); ++i)
+	{
+		HostedMatch& hosted = m_matches[i];
+		if (hosted.overruns_since_report == 0)
+			continue;
+
+		std::cout << "[SERVER] Match " << (i + 1) << " missed " << hosted.overruns_since_report << " tick deadlines in the last second, worst "
+			<< std::fixed << std::setprecision(2) << hosted.worst_since_report.asMicroseconds() / 1000.f << "ms of "
+			<< kTimePerTick.asMicroseconds() / 1000.f << "ms" << std::defaultfloat << std::endl;
+		hosted.overruns_since_report = 0;
+		hosted.worst_since_report = sf::Time::Zero;
+	}
+}
+
+void GameServer::PrintOverrunTotals() const
+{
+	for (int i = 0; i < static_cast<int>(m_matches.size()); ++i)
+	{
+		if (m_matches[i].total_overruns > 0)
+		{
+			std::cout << "[SERVER] Match " << (i + 1) << " missed " << m_matches[i].total_overruns << " tick deadlines in total" << std::endl;
+		}
+	}
+}
+
+void GameServer::SendReliable(int slot)
+{
+	ClientSlot& client = m_clients[slot];
+	if (!client.connected)
+		return;
+
+	m_message.clear();
+	m_message << static_cast<std::uint8_t>(PacketType::kReliable);
+	if (client.channel.Write(m_message, m_clock.getElapsedTime()))
+	{
+		Queue(slot, m_message);
+	}
+}
+
+void GameServer::DropTimedOutClients()
+{
+	const sf::Time now = m_clock.getElapsedTime();
+	for (int i = 0; i < static_cast<int>(m_clients.size()); ++i)
+	{
+		if (m_clients[i].connected && now - m_clients[i].last_heard > kClientTimeout)
+		{
+			std::cout << "[SERVER] Player " << (i % ServerMatch::kMaxPlayers + 1) << " timed out in match " << (i / ServerMatch::kMaxPlayers + 1) << std::endl;
+			DisconnectClient(i, true);
+		}
+	}
+}
+
+void GameServer::DisconnectClient(int slot, bool notify)
+{
+	ClientSlot& client = m_clients[slot];
+	if (!client.connected)
+		return;
+
+	FlushBatch(slot);
+	if (notify)
+	{
+		PooledPacket packet = m_packets.Acquire();
+		*packet << static_cast<std::uint8_t>(PacketType::kLeave);
+		Send(packet, *client.address, client.port);
+	}
+	PushEndpointChange(OutboundDatagram::Kind::kUnbind, slot);
+	client = ClientSlot();
+}
+
+void GameServer::Queue(int slot, const sf::Packet& packet)
+{
+	ClientSlot& client = m_clients[slot];
+	if (client.batch.Add(packet))
+		return;
+
+	FlushBatch(slot);
+	if (!client.batch.Add(packet))
+	{
+		//Too big to share a datagram with anything
+		PooledPacket datagram = m_packets.Acquire();
+		datagram->append(packet.getData(), packet.getDataSize());
+		Send(datagram, *client.address, client.port);
+	}
+}
+
+void GameServer::FlushBatch(int slot)
+{
+	ClientSlot& client = m_clients[slot];
+	if (client.batch.IsEmpty())
+		return;
+
+	PooledPacket datagram = m_packets.Acquire();
+	client.batch.Take(*datagram);
+	Send(datagram, *client.address, client.port);
+}
+
+void GameServer::Send(const PooledPacket& packet, const sf::IpAddress& address, unsigned short port)
+{
+	OutboundDatagram datagram;
+	datagram.address = address;
+	datagram.port = port;
+	datagram.packet = packet;
+	//An I/O thread that can't keep up is no different from a congested link
+	static_cast<void>(m_outbound.TryPush(std::move(datagram)));
+}
+
+void GameServer::PushEndpointChange(OutboundDatagram::Kind kind, int slot)
+{
+	const ClientSlot& client = m_clients[slot];
+	OutboundDatagram change;
+	change.kind = kind;
+	change.slot = slot;
+	change.session = client.session;
+	change.address = client.address;
+	change.port = client.port;
+
+	//Unlike a datagram this can't be dropped, the I/O thread is always draining so the wait is short
+	while (!m_outbound.TryPush(change))
+	{
+		std::this_thread::yield();
+	}
+}
+
+int GameServer::FindClient(const sf::IpAddress& address, unsigned short port) const
+{
+	for (int i = 0; i < static_cast<int>(m_clients.size()); ++i)
+	{
+		const ClientSlot& client = m_clients[i];
+		if (client.connected && client.port == port && *client.address == address)
+			return i;
+	}
+	return -1;
+}
+
+int GameServer::CountConnectedClients(int match) const
+{
+	int count = 0;
+	for (int i = match * ServerMatch::kMaxPlayers; i < (match + 1) * ServerMatch::kMaxPlayers; ++i)
+	{
+		if (m_clients[i].connected)
+			++count;
+	}
+	return count;
+}
+
+std::uint64_t GameServer::GetEndpointKey(const sf::IpAddress& address, unsigned short port)
+{
+	return (static_cast<std::uint64_t>(address.toInteger()) << 16) | port;
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#pragma once
+#include "BitStream.hpp"
+#include "NetworkConfig.hpp"
+#include "NetworkConditioner.hpp"
+#include "PacketBatch.hpp"
+#include "PacketPool.hpp"
+#include "PacketType.hpp"
+#include "InputCodec.hpp"
+#include "PlayerInput.hpp"
+#include "ReliableChannel.hpp"
+#include "ServerMatch.hpp"
+#include "SnapshotHistory.hpp"
+#include "SpscQueue.hpp"
+#include "WorkerPool.hpp"
+#include "WorldSnapshot.hpp"
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/SocketSelector.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+#include <SFML/System/Clock.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//Dedicated authoritative server, run with --server [port] [--matches <count>] [--workers <count>]
+//Clients join over UDP, send their inputs every tick and get a snapshot of the match back every NetworkConfig::kSnapshotInterval ticks
+//Snapshots are delta encoded against the newest one each client has acknowledged, round events go on a reliable channel per client
+//Any number of independent matches are hosted at once, joining clients fill the first free seat. Every tick the matches are stepped
+//in parallel on a WorkerPool and a match still running when its tick should have ended is reported as an overrun
+//The socket lives on its own I/O thread so no send or receive ever holds up a tick. Inputs are decoded there and queued for their match,
+//which takes them in at the start of its next step. Everything a client is sent in a tick goes out as one batched datagram
+class GameServer
+{
+public:
+	static const sf::Time kTimePerTick;
+	static const sf::Time kClientTimeout;
+	static const int kMaxTicksPerFrame;
+	static const sf::Time kIoPollInterval;
+
+	//worker_count 0 uses every hardware thread
+	explicit GameServer(unsigned short port = NetworkConfig::kDefaultPort, int match_count = 1, int worker_count = 0);
+	//Serves until Stop is called, returns false if the port could not be bound
+	bool Run();
+	//Only sets an atomic flag, so it is safe from a signal handler. Run then disconnects everyone and returns
+	void Stop();
+
+private:
+	struct ClientSlot
+	{
+		ClientSlot();
+		bool connected;
+		//Tells the queued traffic of a client apart from that of whoever held the slot before
+		std::uint32_t session;
+		std::optional<sf::IpAddress> address;
+		unsigned short port;
+		sf::Time last_heard;
+		bool has_acked_snapshot;
+		std::uint32_t acked_snapshot_tick;
+		ReliableChannel channel;
+		PacketBatch batch;
+	};
+
+	//Decoded on the I/O thread, taken in by the worker stepping the match
+	struct InputMessage
+	{
+		InputMessage();
+		int slot;
+		std::uint32_t session;
+		sf::Time received;
+		bool has_snapshot;
+		std::uint32_t acked_snapshot_tick;
+		//Oldest first, the packet's redundant history ending with its newest input
+		std::array<PlayerInput, InputCodec::kMaxInputs> inputs;
+		int input_count;
+	};
+
+	//Any other datagram, handled on the server thread at the start of the next tick. slot is -1 for an endpoint that hasn't joined
+	struct InboundDatagram
+	{
+		InboundDatagram();
+		PacketType type;
+		int slot;
+		std::uint32_t session;
+		std::optional<sf::IpAddress> address;
+		unsigned short port;
+		sf::Packet packet;
+	};
+
+	//From the server thread to the I/O thread. Binds and unbinds keep the I/O thread's endpoint lookup in step with the slots
+	struct OutboundDatagram
+	{
+		enum class Kind
+		{
+			kDatagram,
+			kBind,
+			kUnbind
+		};
+
+		OutboundDatagram();
+		Kind kind;
+		int slot;
+		std::uint32_t session;
+		std::optional<sf::IpAddress> address;
+		unsigned short port;
+		PooledPacket packet;
+	};
+
+	struct Endpoint
+	{
+		int slot;
+		std::uint32_t session;
+	};
+
+	//Clients sit in m_clients at match * kMaxPlayers + player
+	struct HostedMatch
+	{
+		HostedMatch();
+		std::unique_ptr<ServerMatch> match;
+		WorldSnapshot snapshot;
+		SnapshotHistory snapshot_history;
+		std::vector<RoundEvent> round_events;
+		//Filled by the I/O thread, drained by whichever worker steps the match
+		std::unique_ptr<SpscQueue<InputMessage>> inputs;
+
+		//Written by the worker that stepped the match, read on the server thread once the batch is done
+		sf::Time tick_duration;
+		int overruns_since_report;
+		sf::Time worst_since_report;
+		std::uint64_t total_overruns;
+	};
+
+private:
+	//I/O thread
+	void IoLoop();
+	void ReceiveDatagrams();
+	void RouteDatagram(sf::Packet& packet, const sf::IpAddress& address, unsigned short port);
+	void SendQueued();
+
+	//Server thread
+	void HandleInbound();
+	void HandlePacket(InboundDatagram& datagram);
+	void HandleJoinRequest(InboundDatagram& datagram);
+	void Tick();
+	void StepMatch(int match);
+	void TakeInputs(int match);
+	void FinishMatchTick(int match);
+	void ResetMatch(int match);
+	void BroadcastSnapshot(int match);
+	void BroadcastRoundEvents(int match);
+	void ReportOverruns();
+	void PrintOverrunTotals() const;
+	void SendReliable(int slot);
+	void DropTimedOutClients();
+	void DisconnectClient(int slot, bool notify);
+	void Queue(int slot, const sf::Packet& packet);
+	void FlushBatch(int slot);
+	void Send(const PooledPacket& packet, const sf::IpAddress& address, unsigned short port);
+	void PushEndpointChange(OutboundDatagram::Kind kind, int slot);
+
+	int FindClient(const sf::IpAddress& address, unsigned short port) const;
+	int CountConnectedClients(int match) const;
+	static std::uint64_t GetEndpointKey(const sf::IpAddress& address, unsigned short port);
+
+private:
+	unsigned short m_port;
+	sf::Clock m_clock;
+	std::atomic<bool> m_running;
+
+	//Owned by the I/O thread once it has started
+	sf::UdpSocket m_socket;
+	NetworkConditioner m_link;
+	sf::SocketSelector m_selector;
+	std::unordered_map<std::uint64_t, Endpoint> m_endpoints;
+	std::thread m_io_thread;
+	std::atomic<bool> m_io_running;
+
+	//Declared before the queues so it outlives every packet still referenced from them
+	PacketPool m_packets;
+	SpscQueue<InboundDatagram> m_inbound;
+	SpscQueue<OutboundDatagram> m_outbound;
+
+	//Server thread only, apart from a match's own slots which its worker updates from the queued inputs while stepping it
+	std::vector<ClientSlot> m_clients;
+	std::vector<HostedMatch> m_matches;
+	WorkerPool m_pool;
+	std::uint32_t m_next_seed;
+	std::uint32_t m_next_session;
+
+	//When the tick being stepped was due to start, a match finishing more than kTimePerTick after it has overrun
+	sf::Time m_tick_start;
+	int m_ticks_since_report;
+	int m_ticks_since_snapshot;
+	BitWriter m_bit_writer;
+	//Reused for every message that is copied into a batch
+	sf::Packet m_message;
+};
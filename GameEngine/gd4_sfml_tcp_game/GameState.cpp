@@ -9,10 +9,12 @@
 
 GameState::GameState(StateStack& stack, Context context) : State(stack, context), m_world(*context.window, *context.fonts, *context.sounds), m_players{ { Player(0), Player(1) } }, m_sounds(*context.sounds)
 {
+	m_world.SetProfiler(context.profiler);
+
 	//Play the music
 	context.music->Play(MusicThemes::kMissionTheme);
 
-	auto& config = PlayerBindingConfig::GetInstance();
+	const PlayerBindingConfig& config = *context.bindings;
 
 	if (config.HasBindings())
 	{
@@ -65,7 +67,7 @@ GameState::GameState(StateStack& stack, Context context) : State(stack, context)
 
 void GameState::Draw()
 {
-	m_world.Draw();
+	m_world.Draw(GetInterpolationAlpha());
 }
 
 bool GameState::Update(sf::Time dt)
@@ -162,6 +164,10 @@ bool GameState::HandleEvent(const sf::Event& event)
 	{
 		if (keyPressed->scancode == sf::Keyboard::Scancode::Escape)
 			RequestStackPush(StateID::kPause);
+
+		//F3 toggles the frame profiler overlay, which pops itself on the next F3
+		if (keyPressed->code == sf::Keyboard::Key::F3)
+			RequestStackPush(StateID::kProfiler);
 	}
 	return true;
 }
@@ -0,0 +1,38 @@
+#include "HitboxHistory.hpp"
+
+HitboxHistory::HitboxHistory() : m_entries()
+{
+}
+
+void HitboxHistory::Record(std::uint32_t tick, int player_index, const sf::FloatRect& rect)
+{
+	if (player_index < 0 || player_index >= WorldSnapshot::kMaxPlayers)
+		return;
+
+	Entry& entry = m_entries[player_index][tick % kCapacity];
+	entry.valid = true;
+	entry.tick = tick;
+	entry.rect = rect;
+}
+
+const sf::FloatRect* HitboxHistory::Find(std::uint32_t tick, int player_index) const
+{
+	if (player_index < 0 || player_index >= WorldSnapshot::kMaxPlayers)
+		return nullptr;
+
+	const Entry& entry = m_entries[player_index][tick % kCapacity];
+	if (entry.valid && entry.tick == tick)
+		return &entry.rect;
+	return nullptr;
+}
+
+void HitboxHistory::Clear()
+{
+	for (auto& player_entries : m_entries)
+	{
+		for (Entry& entry : player_entries)
+		{
+			entry.valid = false;
+		}
+	}
+}
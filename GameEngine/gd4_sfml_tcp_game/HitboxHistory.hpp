@@ -0,0 +1,30 @@
+#pragma once
+#include "WorldSnapshot.hpp"
+#include <SFML/Graphics/Rect.hpp>
+#include <array>
+#include <cstdint>
+
+//Where each player's hitbox was over the last kCapacity ticks (about 250ms), so the server can check shots against what the shooter saw
+//Fixed size and overwritten in place, recording and rewinding never allocate
+class HitboxHistory
+{
+public:
+	static const int kCapacity = 16;
+
+	HitboxHistory();
+	void Record(std::uint32_t tick, int player_index, const sf::FloatRect& rect);
+	//Null when the tick has been overwritten or that player wasn't recorded then
+	const sf::FloatRect* Find(std::uint32_t tick, int player_index) const;
+	void Clear();
+
+private:
+	struct Entry
+	{
+		bool valid = false;
+		std::uint32_t tick = 0;
+		sf::FloatRect rect;
+	};
+
+private:
+	std::array<std::array<Entry, kCapacity>, WorldSnapshot::kMaxPlayers> m_entries;
+};
@@ -0,0 +1,77 @@
+#include "InputBuffer.hpp"
+
+InputBuffer::InputBuffer()
+	: m_entries()
+	, m_last_tick(0)
+	, m_newest_tick(0)
+{
+}
+
+bool InputBuffer::Insert(const PlayerInput& input)
+{
+	if (input.tick <= m_last_tick)
+		return false;
+
+	//The match wasn't running or the client raced ahead, nothing queued is worth keeping
+	if (input.tick - m_last_tick > kCapacity)
+	{
+		for (Entry& entry : m_entries)
+		{
+			entry.valid = false;
+		}
+		m_last_tick = input.tick - 1;
+		m_newest_tick = m_last_tick;
+	}
+
+	Entry& entry = m_entries[input.tick % kCapacity];
+	if (entry.valid && entry.input.tick == input.tick)
+		return false;
+
+	entry.input = input;
+	entry.valid = true;
+	if (input.tick > m_newest_tick)
+	{
+		m_newest_tick = input.tick;
+	}
+	return true;
+}
+
+bool InputBuffer::Pop(PlayerInput& input, unsigned int press_mask)
+{
+	std::uint32_t queued = 0;
+	for (std::uint32_t tick = m_last_tick + 1; tick <= m_newest_tick; ++tick)
+	{
+		const Entry& entry = m_entries[tick % kCapacity];
+		if (entry.valid && entry.input.tick == tick)
+			++queued;
+	}
+	if (queued == 0)
+		return false;
+
+	unsigned int carried_presses = 0;
+	for (std::uint32_t tick = m_last_tick + 1; tick <= m_newest_tick; ++tick)
+	{
+		Entry& entry = m_entries[tick % kCapacity];
+		if (!entry.valid || entry.input.tick != tick)
+			continue;
+
+		entry.valid = false;
+		m_last_tick = tick;
+		if (queued > kMaxBacklog)
+		{
+			--queued;
+			carried_presses |= entry.input.actions & press_mask;
+			continue;
+		}
+
+		input = entry.input;
+		input.actions = static_cast<std::uint8_t>(input.actions | carried_presses);
+		return true;
+	}
+	return false;
+}
+
+std::uint32_t InputBuffer::GetLastTick() const
+{
+	return m_last_tick;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "PlayerInput.hpp"
+#include <array>
+#include <cstdint>
+
+//One player's inputs on the server, queued by tick so every client tick is applied once and in order
+//Clients resend recent inputs in every packet, the copies of a tick already queued or applied are dropped here
+class InputBuffer
+{
+public:
+	static const std::uint32_t kCapacity = 32;
+	//A queue longer than this is input lag, the oldest inputs are merged into the next instead of each taking a tick
+	static const std::uint32_t kMaxBacklog = 3;
+
+	InputBuffer();
+	//False for a tick that was already received or has been passed
+	bool Insert(const PlayerInput& input);
+	//Takes the oldest queued input, skipping lost ticks rather than waiting for them. Bits of press_mask set in
+	//inputs merged away to catch up are carried over so a jump or shot is never dropped. False when nothing is queued
+	bool Pop(PlayerInput& input, unsigned int press_mask);
+	//The newest tick popped, 0 before the first
+	std::uint32_t GetLastTick() const;
+
+private:
+	struct Entry
+	{
+		bool valid = false;
+		PlayerInput input;
+	};
+
+private:
+	std::array<Entry, kCapacity> m_entries;
+	std::uint32_t m_last_tick;
+	std::uint32_t m_newest_tick;
+};
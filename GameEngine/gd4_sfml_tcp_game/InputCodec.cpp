@@ -0,0 +1,135 @@
+#include "InputCodec.hpp"
+#include "Action.hpp"
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+	const int kTickBits = 32;
+	const int kHistoryCountBits = 4;
+	const int kActionBits = static_cast<int>(Action::kActionCount);
+
+	//Aim only sets a direction, so it travels as an angle
+	const float kAngleMin = -180.f;
+	const float kAngleStep = 360.f / 4096.f;
+	const int kAngleBits = 12;
+	const float kDegreesToRadians = 3.14159265f / 180.f;
+
+	//The view tick of the tick before mostly trails by 0 or 1, 7 escapes to a full tick
+	const int kViewTickDeltaBits = 3;
+	const std::uint32_t kViewTickEscape = (1u << kViewTickDeltaBits) - 1;
+
+	bool HasAim(const sf::Vector2f& aim)
+	{
+		//Same cut off as World::SetPlayerAimDirection, anything below it keeps the current aim
+		const float epsilon = 0.001f;
+		return std::abs(aim.x) >= epsilon || std::abs(aim.y) >= epsilon;
+	}
+
+	sf::Vector2f AngleToAim(float degrees)
+	{
+		return { std::cos(degrees * kDegreesToRadians), std::sin(degrees * kDegreesToRadians) };
+	}
+}
+
+void InputCodec::Quantize(PlayerInput& input)
+{
+	if (!HasAim(input.aim))
+	{
+		input.aim = { 0.f, 0.f };
+		return;
+	}
+	const float degrees = std::atan2(input.aim.y, input.aim.x) / kDegreesToRadians;
+	input.aim = AngleToAim(BitWriter::Quantize(degrees, kAngleMin, kAngleStep, kAngleBits));
+}
+
+void InputCodec::Write(BitWriter& writer, const PlayerInput* inputs, int count)
+{
+	//The count travels as count - 1, an empty history has no encoding
+	assert(count >= 1 && count <= kMaxInputs);
+	if (count < 1)
+		return;
+
+	const PlayerInput& newest = inputs[0];
+	writer.Write(newest.tick, kTickBits);
+	writer.Write(static_cast<std::uint32_t>(count - 1), kHistoryCountBits);
+	writer.Write(newest.actions, kActionBits);
+	WriteAim(writer, newest.aim);
+	writer.Write(newest.view_tick, kTickBits);
+
+	for (int i = 1; i < count; ++i)
+	{
+		const PlayerInput& input = inputs[i];
+		const PlayerInput& newer = inputs[i - 1];
+		const bool repeat = input.actions == newer.actions && input.aim == newer.aim;
+		writer.WriteBool(repeat);
+		if (!repeat)
+		{
+			writer.Write(input.actions, kActionBits);
+			WriteAim(writer, input.aim);
+		}
+
+		const std::uint32_t view_delta = newer.view_tick - input.view_tick;
+		if (newer.view_tick >= input.view_tick && view_delta < kViewTickEscape)
+		{
+			writer.Write(view_delta, kViewTickDeltaBits);
+		}
+		else
+		{
+			writer.Write(kViewTickEscape, kViewTickDeltaBits);
+			writer.Write(input.view_tick, kTickBits);
+		}
+	}
+}
+
+bool InputCodec::Read(BitReader& reader, PlayerInput* inputs, int& count)
+{
+	PlayerInput newest;
+	newest.tick = reader.Read(kTickBits);
+	count = static_cast<int>(reader.Read(kHistoryCountBits)) + 1;
+	newest.actions = static_cast<std::uint8_t>(reader.Read(kActionBits));
+	newest.aim = ReadAim(reader);
+	newest.view_tick = reader.Read(kTickBits);
+
+	//Decoded newest first into the back, so the caller can apply them oldest first
+	inputs[count - 1] = newest;
+	for (int i = count - 2; i >= 0; --i)
+	{
+		const PlayerInput& newer = inputs[i + 1];
+		PlayerInput& input = inputs[i];
+		input.tick = newer.tick - 1;
+		if (reader.ReadBool())
+		{
+			input.actions = newer.actions;
+			input.aim = newer.aim;
+		}
+		else
+		{
+			input.actions = static_cast<std::uint8_t>(reader.Read(kActionBits));
+			input.aim = ReadAim(reader);
+		}
+
+		const std::uint32_t view_delta = reader.Read(kViewTickDeltaBits);
+		input.view_tick = view_delta == kViewTickEscape ? reader.Read(kTickBits) : newer.view_tick - view_delta;
+	}
+
+	//Tick 0 is never sent, history reaching back past it means a corrupt packet
+	return reader.IsValid() && newest.tick >= static_cast<std::uint32_t>(count);
+}
+
+void InputCodec::WriteAim(BitWriter& writer, const sf::Vector2f& aim)
+{
+	const bool has_aim = HasAim(aim);
+	writer.WriteBool(has_aim);
+	if (has_aim)
+	{
+		writer.WriteQuantized(std::atan2(aim.y, aim.x) / kDegreesToRadians, kAngleMin, kAngleStep, kAngleBits);
+	}
+}
+
+sf::Vector2f InputCodec::ReadAim(BitReader& reader)
+{
+	if (!reader.ReadBool())
+		return { 0.f, 0.f };
+	return AngleToAim(reader.ReadQuantized(kAngleMin, kAngleStep, kAngleBits));
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "BitStream.hpp"
+#include "PlayerInput.hpp"
+
+//Bit packed PlayerInput history for redundant input packets: the newest input in full, then the ticks before it
+//each coded against the one after it. An older input repeating the actions and aim of its successor costs a bit
+//for that plus three for its view tick, so resending the last kMaxHistory ticks in every packet stays cheap
+class InputCodec
+{
+public:
+	static const int kMaxHistory = 15;
+	static const int kMaxInputs = kMaxHistory + 1;
+
+	//Rounds the aim to the direction that survives encoding, clients predict with the rounded input
+	static void Quantize(PlayerInput& input);
+	//inputs is newest first, on consecutive ticks counting down, count between 1 and kMaxInputs
+	static void Write(BitWriter& writer, const PlayerInput* inputs, int count);
+	//Fills inputs oldest first, it must have room for kMaxInputs. Returns false for a truncated packet
+	static bool Read(BitReader& reader, PlayerInput* inputs, int& count);
+
+private:
+	static void WriteAim(BitWriter& writer, const sf::Vector2f& aim);
+	static sf::Vector2f ReadAim(BitReader& reader);
+};
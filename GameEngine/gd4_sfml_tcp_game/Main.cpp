@@ -3,15 +3,192 @@
 #include "ResourceIdentifiers.hpp"
 #include <iostream>
 #include "Application.hpp"
+#include "World.hpp"
+#include "Benchmark.hpp"
+#include "TraceRecorder.hpp"
+#include "GameServer.hpp"
+#include "NetworkConfig.hpp"
+#include <atomic>
+#include <charconv>
+#include <csignal>
+#include <stdexcept>
+#include <string>
 
-int main()
+namespace
+{
+	//Steps a headless World at the game's fixed timestep as fast as the CPU allows
+	void RunHeadless(int ticks)
+	{
+		const sf::Time time_per_frame = sf::seconds(1.f / 60.f);
+		World world;
+
+		sf::Clock clock;
+		for (int i = 0; i < ticks; ++i)
+		{
+			world.Update(time_per_frame);
+		}
+		float elapsed = clock.getElapsedTime().asSeconds();
+
+		std::cout << "Simulated " << ticks << " ticks (" << ticks * time_per_frame.asSeconds() << "s game time) in "
+			<< elapsed << "s, " << (elapsed > 0.f ? ticks / elapsed : 0.f) << " ticks/sec" << std::endl;
+		std::cout << "Round " << world.GetRoundNumber() << ", scores "
+			<< world.GetPlayerScore(0) << " - " << world.GetPlayerScore(1) << std::endl;
+	}
+
+	//Starts recording for --trace <file> and writes the trace when the run finishes, even through an exception
+	class TraceSession
+	{
+	public:
+		TraceSession(int argc, char* argv[])
+		{
+			for (int i = 1; i + 1 < argc; ++i)
+			{
+				if (std::string(argv[i]) == "--trace")
+				{
+					m_filename = argv[i + 1];
+					TraceRecorder::Start();
+					break;
+				}
+			}
+		}
+
+		~TraceSession()
+		{
+			if (!m_filename.empty() && !TraceRecorder::Stop(m_filename))
+			{
+				std::cout << "Failed to write trace to " << m_filename << std::endl;
+			}
+		}
+
+	private:
+		std::string m_filename;
+	};
+
+	//Ctrl+C or a terminate request shuts the dedicated server down cleanly, so clients are told and the totals get printed
+	std::atomic<GameServer*> running_server{ nullptr };
+
+	void StopRunningServer(int)
+	{
+		if (GameServer* server = running_server.load())
+		{
+			server->Stop();
+		}
+	}
+
+	bool IsOption(const char* argument)
+	{
+		return std::string(argument).rfind("--", 0) == 0;
+	}
+
+	//A bad number on the command line ends the run with the usage instead of an uncaught exception
+	template <typename T>
+	T ParseNumber(const std::string& option, const char* text)
+	{
+		const std::string value = text;
+		T result{};
+		const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+		if (error != std::errc() || end != value.data() + value.size())
+			throw std::invalid_argument("Invalid value '" + value + "' for " + option);
+		return result;
+	}
+
+	unsigned short ParsePort(const char* text)
+	{
+		const int port = ParseNumber<int>("port", text);
+		if (port < 1 || port > 65535)
+			throw std::invalid_argument("Port must be between 1 and 65535, got " + std::string(text));
+		return static_cast<unsigned short>(port);
+	}
+
+	int GetIntOption(int argc, char* argv[], const std::string& option, int fallback)
+	{
+		for (int i = 1; i + 1 < argc; ++i)
+		{
+			if (argv[i] == option)
+				return ParseNumber<int>(option, argv[i + 1]);
+		}
+		return fallback;
+	}
+
+	//--net-latency <ms> --net-jitter <ms> --net-loss <%> --net-duplicate <%> --net-reorder <%> simulate a bad link for the server or the client
+	void ParseNetworkConditions(int argc, char* argv[])
+	{
+		NetworkConditions conditions;
+		for (int i = 1; i + 1 < argc; ++i)
+		{
+			const std::string option = argv[i];
+			if (option == "--net-latency")
+				conditions.latency = sf::milliseconds(ParseNumber<int>(option, argv[i + 1]));
+			else if (option == "--net-jitter")
+				conditions.jitter = sf::milliseconds(ParseNumber<int>(option, argv[i + 1]));
+			else if (option == "--net-loss")
+				conditions.loss = ParseNumber<float>(option, argv[i + 1]) / 100.f;
+			else if (option == "--net-duplicate")
+				conditions.duplicate = ParseNumber<float>(option, argv[i + 1]) / 100.f;
+			else if (option == "--net-reorder")
+				conditions.reorder = ParseNumber<float>(option, argv[i + 1]) / 100.f;
+		}
+		NetworkConfig::GetInstance().SetConditions(conditions);
+	}
+}
+
+int main(int argc, char* argv[])
 {
 	//TextureHolder game_textures;
+	TraceSession trace_session(argc, argv);
 	try
 	{
+		//--headless <ticks> runs the simulation without a window
+		if (argc >= 2 && std::string(argv[1]) == "--headless")
+		{
+			int ticks = argc >= 3 ? ParseNumber<int>("--headless", argv[2]) : 36000;
+			RunHeadless(ticks);
+			return 0;
+		}
+
+		//--benchmark runs the scripted World scenarios and scene graph micro benchmarks
+		if (argc >= 2 && std::string(argv[1]) == "--benchmark")
+		{
+			Benchmark benchmark;
+			benchmark.Run();
+			return 0;
+		}
+
+		//--server [port] [--matches <count>] [--workers <count>] runs a dedicated authoritative server without a window
+		//Every match seats two clients, the matches are stepped on a pool of worker threads (0 uses every hardware thread)
+		if (argc >= 2 && std::string(argv[1]) == "--server")
+		{
+			unsigned short port = argc >= 3 && !IsOption(argv[2]) ? ParsePort(argv[2]) : NetworkConfig::kDefaultPort;
+			ParseNetworkConditions(argc, argv);
+			GameServer server(port, GetIntOption(argc, argv, "--matches", 1), GetIntOption(argc, argv, "--workers", 0));
+			running_server = &server;
+			std::signal(SIGINT, StopRunningServer);
+			std::signal(SIGTERM, StopRunningServer);
+			const bool served = server.Run();
+			std::signal(SIGINT, SIG_DFL);
+			std::signal(SIGTERM, SIG_DFL);
+			running_server = nullptr;
+			return served ? 0 : 1;
+		}
+
+		//--connect <host> [port] picks the server the Online menu option joins
+		if (argc >= 3 && std::string(argv[1]) == "--connect")
+		{
+			unsigned short port = argc >= 4 && !IsOption(argv[3]) ? ParsePort(argv[3]) : NetworkConfig::kDefaultPort;
+			NetworkConfig::GetInstance().SetServer(argv[2], port);
+		}
+		ParseNetworkConditions(argc, argv);
+
 		Application app;
 		app.Run();
 	}
+	catch(std::invalid_argument& e)
+	{
+		std::cout << e.what() << std::endl;
+		std::cout << "Usage: [--headless <ticks>] [--benchmark] [--server [port] [--matches <count>] [--workers <count>]] [--connect <host> [port]]"
+			<< " [--net-latency <ms>] [--net-jitter <ms>] [--net-loss <%>] [--net-duplicate <%>] [--net-reorder <%>] [--trace <file>]" << std::endl;
+		return 1;
+	}
 	catch(std::runtime_error& e)
 	{
 		std::cout << e.what() << std::endl;
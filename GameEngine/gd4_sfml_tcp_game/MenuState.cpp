@@ -20,8 +20,17 @@ MenuState::MenuState(StateStack& stack, Context context)
         RequestStackPush(StateID::kBinding);
     });
 
+    auto online_button = std::make_shared<gui::Button>(context);
+    online_button->setPosition({ 100, 300 });
+    online_button->SetText("Online");
+    online_button->SetCallback([this]()
+    {
+        RequestStackPop();
+        RequestStackPush(StateID::kNetworkGame);
+    });
+
     auto settings_button = std::make_shared<gui::Button>(context);
-    settings_button->setPosition({ 100, 300 });
+    settings_button->setPosition({ 100, 350 });
     settings_button->SetText("Settings");
     settings_button->SetCallback([this]()
     {
@@ -29,7 +38,7 @@ MenuState::MenuState(StateStack& stack, Context context)
     });
 
     auto exit_button = std::make_shared<gui::Button>(context);
-    exit_button->setPosition({ 100, 350 });
+    exit_button->setPosition({ 100, 400 });
     exit_button->SetText("Exit");
     exit_button->SetCallback([this]()
     {
@@ -37,6 +46,7 @@ MenuState::MenuState(StateStack& stack, Context context)
     });
 
     m_gui_container.Pack(play_button);
+    m_gui_container.Pack(online_button);
     m_gui_container.Pack(settings_button);
     m_gui_container.Pack(exit_button);
 
@@ -0,0 +1,194 @@
+#include "NetworkConditioner.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+	//A reordered datagram is held back this much longer than its neighbours so it lands behind the next few
+	const sf::Time kReorderDelay = sf::milliseconds(30);
+}
+
+bool NetworkConditioner::LaterFirst::operator()(const Datagram& a, const Datagram& b) const
+{
+	if (a.due != b.due)
+		return a.due > b.due;
+	return a.order > b.order;
+}
+
+NetworkConditioner::NetworkConditioner(sf::UdpSocket& socket)
+	: m_socket(socket)
+	, m_conditions()
+	, m_random(std::random_device{}())
+	, m_next_order(0)
+	, m_packets_sent(0)
+	, m_bytes_sent(0)
+	, m_packets_received(0)
+	, m_bytes_received(0)
+	, m_packets_dropped(0)
+	, m_packets_duplicated(0)
+{
+}
+
+void NetworkConditioner::SetConditions(const NetworkConditions& conditions)
+{
+	m_conditions = conditions;
+}
+
+sf::Socket::Status NetworkConditioner::Send(sf::Packet& packet, const sf::IpAddress& address, unsigned short port)
+{
+	++m_packets_sent;
+	m_bytes_sent += packet.getDataSize();
+
+	if (!m_conditions.IsEnabled())
+		return m_socket.send(packet, address, port);
+
+	Hold(m_outgoing, packet.getData(), packet.getDataSize(), address, port);
+	Update();
+	return sf::Socket::Status::Done;
+}
+
+sf::Socket::Status NetworkConditioner::Receive(sf::Packet& packet, std::optional<sf::IpAddress>& address, unsigned short& port)
+{
+	if (!m_conditions.IsEnabled())
+	{
+		sf::Socket::Status status = m_socket.receive(packet, address, port);
+		if (status == sf::Socket::Status::Done)
+		{
+			++m_packets_received;
+			m_bytes_received += packet.getDataSize();
+		}
+		return status;
+	}
+
+	//Everything waiting in the socket joins the queue, then only what is due comes out
+	std::optional<sf::IpAddress> sender;
+	unsigned short sender_port = 0;
+	while (m_socket.receive(m_scratch, sender, sender_port) == sf::Socket::Status::Done)
+	{
+		if (sender)
+		{
+			Hold(m_incoming, m_scratch.getData(), m_scratch.getDataSize(), *sender, sender_port);
+		}
+	}
+
+	if (m_incoming.empty() || m_incoming.front().due > m_clock.getElapsedTime())
+		return sf::Socket::Status::NotReady;
+
+	std::pop_heap(m_incoming.begin(), m_incoming.end(), LaterFirst());
+	Datagram& datagram = m_incoming.back();
+	packet.clear();
+	packet.append(datagram.data.data(), datagram.data.size());
+	address = datagram.address;
+	port = datagram.port;
+	m_incoming.pop_back();
+
+	++m_packets_received;
+	m_bytes_received += packet.getDataSize();
+	return sf::Socket::Status::Done;
+}
+
+void NetworkConditioner::Update()
+{
+	const sf::Time now = m_clock.getElapsedTime();
+	while (!m_outgoing.empty() && m_outgoing.front().due <= now)
+	{
+		std::pop_heap(m_outgoing.begin(), m_outgoing.end(), LaterFirst());
+		SendNow(m_outgoing.back());
+		m_outgoing.pop_back();
+	}
+}
+
+void NetworkConditioner::Flush()
+{
+	std::sort(m_outgoing.begin(), m_outgoing.end(), [](const Datagram& a, const Datagram& b)
+		{
+			return LaterFirst()(b, a);
+		});
+	for (const Datagram& datagram : m_outgoing)
+	{
+		SendNow(datagram);
+	}
+	m_outgoing.clear();
+}
+
+std::optional<sf::Time> NetworkConditioner::GetTimeUntilNextDelivery() const
+{
+	std::optional<sf::Time> next_due;
+	if (!m_outgoing.empty())
+		next_due = m_outgoing.front().due;
+	if (!m_incoming.empty() && (!next_due || m_incoming.front().due < *next_due))
+		next_due = m_incoming.front().due;
+
+	if (!next_due)
+		return std::nullopt;
+	return std::max(sf::Time::Zero, *next_due - m_clock.getElapsedTime());
+}
+
+void NetworkConditioner::PrintStatistics(const std::string& name) const
+{
+	const float seconds = m_clock.getElapsedTime().asSeconds();
+	const float kbit_per_byte = 8.f / 1000.f;
+	std::cout << "[" << name << "] Sent " << m_packets_sent << " packets, " << m_bytes_sent << " bytes ("
+		<< (seconds > 0.f ? m_bytes_sent * kbit_per_byte / seconds : 0.f) << " kbit/s), received "
+		<< m_packets_received << " packets, " << m_bytes_received << " bytes ("
+		<< (seconds > 0.f ? m_bytes_received * kbit_per_byte / seconds : 0.f) << " kbit/s)" << std::endl;
+
+	if (m_conditions.IsEnabled())
+	{
+		std::cout << "[" << name << "] Simulated " << m_conditions.latency.asMilliseconds() << "ms +-"
+			<< m_conditions.jitter.asMilliseconds() << "ms: dropped " << m_packets_dropped
+			<< ", duplicated " << m_packets_duplicated << std::endl;
+	}
+}
+
+void NetworkConditioner::Hold(std::vector<Datagram>& queue, const void* data, std::size_t size, const sf::IpAddress& address, unsigned short port)
+{
+	if (Roll(m_conditions.loss))
+	{
+		++m_packets_dropped;
+		return;
+	}
+
+	const int copies = Roll(m_conditions.duplicate) ? 2 : 1;
+	if (copies > 1)
+	{
+		++m_packets_duplicated;
+	}
+
+	const std::byte* bytes = static_cast<const std::byte*>(data);
+	for (int i = 0; i < copies; ++i)
+	{
+		queue.push_back({ m_clock.getElapsedTime() + RollDelay(), m_next_order++, std::vector<std::byte>(bytes, bytes + size), address, port });
+		std::push_heap(queue.begin(), queue.end(), LaterFirst());
+	}
+}
+
+sf::Time NetworkConditioner::RollDelay()
+{
+	sf::Time delay = m_conditions.latency;
+	if (m_conditions.jitter > sf::Time::Zero)
+	{
+		std::uniform_int_distribution<std::int64_t> jitter(-m_conditions.jitter.asMicroseconds(), m_conditions.jitter.asMicroseconds());
+		delay += sf::microseconds(jitter(m_random));
+	}
+	if (Roll(m_conditions.reorder))
+	{
+		delay += kReorderDelay;
+	}
+	return std::max(sf::Time::Zero, delay);
+}
+
+bool NetworkConditioner::Roll(float chance)
+{
+	if (chance <= 0.f)
+		return false;
+	return std::uniform_real_distribution<float>(0.f, 1.f)(m_random) < chance;
+}
+
+void NetworkConditioner::SendNow(const Datagram& datagram)
+{
+	m_scratch.clear();
+	m_scratch.append(datagram.data.data(), datagram.data.size());
+	//A refused datagram is just another lost one
+	static_cast<void>(m_socket.send(m_scratch, datagram.address, datagram.port));
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "NetworkConditions.hpp"
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+#include <SFML/System/Clock.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+//Sits between the game and its UdpSocket and makes loopback behave like a bad link: latency, jitter, loss, duplication and reordering
+//Both directions of the process it runs in are affected, so enabling it on one end is enough to test a bad client or a bad server
+//With no conditions set everything passes straight through, only the traffic counters are kept
+class NetworkConditioner
+{
+public:
+	explicit NetworkConditioner(sf::UdpSocket& socket);
+	void SetConditions(const NetworkConditions& conditions);
+
+	//Same contracts as sf::UdpSocket. A datagram "lost" on the way out still reports Done, like a real one would
+	sf::Socket::Status Send(sf::Packet& packet, const sf::IpAddress& address, unsigned short port);
+	sf::Socket::Status Receive(sf::Packet& packet, std::optional<sf::IpAddress>& address, unsigned short& port);
+
+	//Sends the held back datagrams that are due, call it at least once a tick
+	void Update();
+	//Sends everything still held back straight away, for goodbyes before the socket closes
+	void Flush();
+	//How long until a held back datagram is due either way, nothing if none are held
+	std::optional<sf::Time> GetTimeUntilNextDelivery() const;
+
+	void PrintStatistics(const std::string& name) const;
+
+private:
+	struct Datagram
+	{
+		sf::Time due;
+		std::uint64_t order;
+		std::vector<std::byte> data;
+		sf::IpAddress address;
+		unsigned short port;
+	};
+
+	struct LaterFirst
+	{
+		bool operator()(const Datagram& a, const Datagram& b) const;
+	};
+
+private:
+	void Hold(std::vector<Datagram>& queue, const void* data, std::size_t size, const sf::IpAddress& address, unsigned short port);
+	sf::Time RollDelay();
+	bool Roll(float chance);
+	void SendNow(const Datagram& datagram);
+
+private:
+	sf::UdpSocket& m_socket;
+	NetworkConditions m_conditions;
+	std::mt19937 m_random;
+	sf::Clock m_clock;
+	std::uint64_t m_next_order;
+
+	//Min heaps on due time
+	std::vector<Datagram> m_outgoing;
+	std::vector<Datagram> m_incoming;
+	sf::Packet m_scratch;
+
+	std::uint64_t m_packets_sent;
+	std::uint64_t m_bytes_sent;
+	std::uint64_t m_packets_received;
+	std::uint64_t m_bytes_received;
+	std::uint64_t m_packets_dropped;
+	std::uint64_t m_packets_duplicated;
+};
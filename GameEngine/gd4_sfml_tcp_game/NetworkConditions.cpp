@@ -0,0 +1,15 @@
+#include "NetworkConditions.hpp"
+
+NetworkConditions::NetworkConditions()
+	: latency(sf::Time::Zero)
+	, jitter(sf::Time::Zero)
+	, loss(0.f)
+	, duplicate(0.f)
+	, reorder(0.f)
+{
+}
+
+bool NetworkConditions::IsEnabled() const
+{
+	return latency > sf::Time::Zero || jitter > sf::Time::Zero || loss > 0.f || duplicate > 0.f || reorder > 0.f;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <SFML/System/Time.hpp>
+
+//A bad link to emulate on loopback, set from the --net-* command line options
+//latency is one way, jitter is the most a datagram lands either side of it, the rest are chances from 0 to 1
+struct NetworkConditions
+{
+	NetworkConditions();
+	bool IsEnabled() const;
+
+	sf::Time latency;
+	sf::Time jitter;
+	float loss;
+	float duplicate;
+	float reorder;
+};
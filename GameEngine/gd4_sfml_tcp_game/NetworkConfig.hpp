@@ -0,0 +1,59 @@
+#pragma once
+#include "NetworkConditions.hpp"
+#include <cstdint>
+#include <string>
+
+//Singleton holding the server to join and the link to simulate, set from the command line and read when the network game starts
+class NetworkConfig
+{
+public:
+	static const unsigned short kDefaultPort = 50000;
+	//Bumped whenever a packet layout changes so old clients are turned away instead of misreading
+	static const std::uint16_t kProtocolVersion = 8;
+	//The server simulates at kTicksPerSecond and sends a snapshot every kSnapshotInterval ticks (20 Hz)
+	//Clients interpolate between snapshots, so the send rate is independent of the simulation rate
+	static const int kTicksPerSecond = 60;
+	static const int kSnapshotInterval = 3;
+
+	static NetworkConfig& GetInstance()
+	{
+		static NetworkConfig instance;
+		return instance;
+	}
+
+	void SetServer(const std::string& host, unsigned short port)
+	{
+		m_host = host;
+		m_port = port;
+	}
+
+	const std::string& GetHost() const
+	{
+		return m_host;
+	}
+
+	unsigned short GetPort() const
+	{
+		return m_port;
+	}
+
+	void SetConditions(const NetworkConditions& conditions)
+	{
+		m_conditions = conditions;
+	}
+
+	const NetworkConditions& GetConditions() const
+	{
+		return m_conditions;
+	}
+
+private:
+	std::string m_host = "127.0.0.1";
+	unsigned short m_port = kDefaultPort;
+	NetworkConditions m_conditions;
+
+	NetworkConfig() = default;
+	~NetworkConfig() = default;
+	NetworkConfig(const NetworkConfig&) = delete;
+	NetworkConfig& operator=(const NetworkConfig&) = delete;
+};
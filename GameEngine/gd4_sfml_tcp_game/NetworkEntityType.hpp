@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+//Which kind of Entity a snapshot entry describes, so the client knows what replica to create
+enum class NetworkEntityType : std::uint8_t
+{
+	kAircraft,
+	kProjectile,
+	kBox,
+	kPickup
+};
@@ -0,0 +1,423 @@
+#include "NetworkGameState.hpp"
+#include "InputCodec.hpp"
+#include "NetworkConfig.hpp"
+#include "PacketBatch.hpp"
+#include "PacketType.hpp"
+#include "PlayerBindingConfig.hpp"
+#include "PlayerInput.hpp"
+#include "RoundEvent.hpp"
+#include "ResourceHolder.hpp"
+#include "SnapshotCodec.hpp"
+#include <algorithm>
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <cmath>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+const sf::Time NetworkGameState::kJoinRetryInterval = sf::seconds(0.5f);
+const sf::Time NetworkGameState::kServerTimeout = sf::seconds(5.f);
+const sf::Time NetworkGameState::kInterpolationDelay = sf::seconds(0.1f);
+const sf::Time NetworkGameState::kMaxExtrapolation = sf::seconds(0.1f);
+
+NetworkGameState::NetworkGameState(StateStack& stack, Context context)
+	: State(stack, context)
+	, m_world(*context.window, *context.fonts, *context.sounds)
+	, m_player(0)
+	, m_link(m_socket)
+	, m_server_address(sf::IpAddress::resolve(NetworkConfig::GetInstance().GetHost()))
+	, m_server_port(NetworkConfig::GetInstance().GetPort())
+	, m_player_index(-1)
+	, m_connected_players(0)
+	, m_disconnected(false)
+	, m_join_retry_timer(kJoinRetryInterval)
+	, m_time_since_server(sf::Time::Zero)
+	, m_pending_presses(0)
+	, m_input_tick(0)
+	, m_input_buffer()
+	, m_acknowledged_input(0)
+	, m_input_writer()
+	, m_has_snapshot(false)
+	, m_has_new_snapshot(false)
+	, m_interpolator(sf::seconds(1.f / NetworkConfig::kTicksPerSecond), kInterpolationDelay, kMaxExtrapolation)
+	, m_status_text(context.fonts->Get(Font::kMain))
+{
+	m_world.SetReplica(true);
+	m_world.SetProfiler(context.profiler);
+
+	m_status_text.setCharacterSize(30);
+	m_status_text.setFillColor(sf::Color::White);
+	m_status_text.setOutlineColor(sf::Color::Black);
+	m_status_text.setOutlineThickness(2.f);
+	m_status_text.setPosition({ 20.f, 20.f });
+
+	//The first device picked on the binding screen drives the local player
+	auto device = context.bindings->GetPlayerDevice(0);
+	if (device.has_value() && device->type == InputDeviceType::kController)
+	{
+		m_player.SetJoystickId(device->deviceIndex);
+	}
+
+	if (!m_server_address)
+	{
+		std::cout << "[CLIENT] Could not resolve " << NetworkConfig::GetInstance().GetHost() << std::endl;
+		m_disconnected = true;
+	}
+	else if (m_socket.bind(sf::Socket::AnyPort) != sf::Socket::Status::Done)
+	{
+		std::cout << "[CLIENT] Could not open a UDP socket" << std::endl;
+		m_disconnected = true;
+	}
+	m_socket.setBlocking(false);
+	m_link.SetConditions(NetworkConfig::GetInstance().GetConditions());
+
+	context.music->Play(MusicThemes::kMissionTheme);
+	UpdateStatusText();
+}
+
+NetworkGameState::~NetworkGameState()
+{
+	//Free our seat straight away instead of making the server wait for the timeout
+	if (m_player_index >= 0 && !m_disconnected)
+	{
+		sf::Packet packet;
+		packet << static_cast<std::uint8_t>(PacketType::kLeave);
+		Send(packet);
+	}
+	//Whatever the simulated link still holds back goes out now, the socket closes with this state
+	m_link.Flush();
+	m_link.PrintStatistics("CLIENT");
+}
+
+void NetworkGameState::Draw()
+{
+	m_world.Draw(GetInterpolationAlpha());
+
+	if (!m_status_text.getString().isEmpty())
+	{
+		sf::RenderWindow& window = *GetContext().window;
+		window.setView(window.getDefaultView());
+		window.draw(m_status_text);
+	}
+}
+
+bool NetworkGameState::Update(sf::Time dt)
+{
+	ReceivePackets();
+
+	m_time_since_server += dt;
+	if (m_time_since_server > kServerTimeout && !m_disconnected)
+	{
+		std::cout << "[CLIENT] No response from the server" << std::endl;
+		m_disconnected = true;
+	}
+
+	if (m_disconnected || m_world.ShouldReturnToMenu())
+	{
+		RequestStackClear();
+		RequestStackPush(StateID::kMenu);
+		return false;
+	}
+
+	if (m_player_index < 0)
+	{
+		m_join_retry_timer += dt;
+		if (m_join_retry_timer >= kJoinRetryInterval)
+		{
+			m_join_retry_timer = sf::Time::Zero;
+			SendJoinRequest();
+		}
+	}
+	else
+	{
+		SendInput();
+
+		//Acknowledges the round events received this frame, the server resends anything we don't
+		sf::Packet packet;
+		packet << static_cast<std::uint8_t>(PacketType::kReliable);
+		if (m_channel.Write(packet, m_clock.getElapsedTime()))
+		{
+			Send(packet);
+		}
+	}
+	m_link.Update();
+
+	//The world update first saves where everything is drawn from, so snapshot corrections and the predicted step are blended like any other movement
+	m_world.Update(dt);
+
+	m_interpolator.Update(dt);
+	if (m_has_new_snapshot)
+	{
+		m_interpolator.Push(m_snapshot);
+	}
+	if (m_interpolator.Sample(m_render_snapshot))
+	{
+		m_world.ApplySnapshot(m_render_snapshot);
+	}
+
+	if (m_has_new_snapshot)
+	{
+		m_has_new_snapshot = false;
+		m_world.ResetPredictedPlayer(m_player_index, m_snapshot);
+		ReplayUnacknowledgedInput(dt);
+	}
+	else if (m_player_index >= 0)
+	{
+		m_world.PredictPlayer(m_player_index, m_player, m_input_buffer[m_input_tick % kInputBufferSize], dt);
+	}
+
+	UpdateStatusText();
+	return true;
+}
+
+bool NetworkGameState::HandleEvent(const sf::Event& event)
+{
+	//Presses are kept until the next input packet so a tap between ticks still reaches the server
+	m_pending_presses |= m_player.GetEventActions(event);
+
+	if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
+	{
+		//There is no pausing a shared match, escape leaves it
+		if (keyPressed->scancode == sf::Keyboard::Scancode::Escape)
+		{
+			RequestStackClear();
+			RequestStackPush(StateID::kMenu);
+		}
+
+		if (keyPressed->code == sf::Keyboard::Key::F3)
+			RequestStackPush(StateID::kProfiler);
+	}
+	return true;
+}
+
+void NetworkGameState::ReceivePackets()
+{
+	sf::Packet packet;
+	std::optional<sf::IpAddress> address;
+	unsigned short port = 0;
+	while (m_link.Receive(packet, address, port) == sf::Socket::Status::Done)
+	{
+		//Ignore anything that isn't from our server
+		if (address && address == m_server_address && port == m_server_port)
+		{
+			m_time_since_server = sf::Time::Zero;
+			HandlePacket(packet);
+		}
+	}
+}
+
+void NetworkGameState::HandlePacket(sf::Packet& packet)
+{
+	std::uint8_t type = 0;
+	if (!(packet >> type))
+		return;
+
+	switch (static_cast<PacketType>(type))
+	{
+	case PacketType::kJoinAccepted:
+	{
+		std::uint8_t slot = 0;
+		if (packet >> slot && m_player_index < 0)
+		{
+			m_player_index = slot;
+			m_world.SetPredictedPlayer(m_player_index);
+			std::cout << "[CLIENT] Joined as player " << (m_player_index + 1) << std::endl;
+		}
+		break;
+	}
+	case PacketType::kJoinRejected:
+		std::cout << "[CLIENT] The server is full" << std::endl;
+		m_disconnected = true;
+		break;
+	case PacketType::kSnapshot:
+	{
+		std::uint8_t connected_players = 0;
+		std::uint32_t tick = 0;
+		std::uint8_t baseline_age = 0;
+		packet >> connected_players >> tick >> baseline_age;
+		//Every player's last input tick is sent, so all clients sharing a baseline can be sent the same bytes
+		std::uint32_t acknowledged_input = 0;
+		for (int i = 0; i < WorldSnapshot::kMaxPlayers; ++i)
+		{
+			std::uint32_t last_input_tick = 0;
+			packet >> last_input_tick;
+			if (i == m_player_index)
+			{
+				acknowledged_input = last_input_tick;
+			}
+		}
+		if (!packet)
+			break;
+
+		//Datagrams can arrive out of order, only ever move forwards
+		if (m_has_snapshot && tick < m_snapshot.tick)
+			break;
+
+		//A delta against a snapshot we no longer hold can't be decoded, the next one will use a newer acknowledgement
+		const WorldSnapshot* baseline = nullptr;
+		if (baseline_age > 0)
+		{
+			baseline = m_snapshot_history.Find(tick - baseline_age);
+			if (!baseline)
+				break;
+		}
+
+		BitReader reader(packet);
+		if (!SnapshotCodec::Read(reader, m_incoming_snapshot, baseline))
+			break;
+		m_incoming_snapshot.tick = tick;
+		m_snapshot_history.Store(m_incoming_snapshot);
+
+		std::swap(m_snapshot, m_incoming_snapshot);
+		m_has_snapshot = true;
+		m_has_new_snapshot = true;
+		m_connected_players = connected_players;
+		//A seat taken over from another client can report ticks this client never sent
+		m_acknowledged_input = std::max(m_acknowledged_input, std::min(acknowledged_input, m_input_tick));
+		break;
+	}
+	case PacketType::kReliable:
+		if (m_channel.Read(packet, m_clock.getElapsedTime()))
+		{
+			ReceiveRoundEvents();
+		}
+		break;
+	case PacketType::kLeave:
+		std::cout << "[CLIENT] The server closed the match" << std::endl;
+		m_disconnected = true;
+		break;
+	case PacketType::kBatch:
+	{
+		//Nested batches are never sent, so each part is handled like a datagram of its own
+		std::vector<sf::Packet> messages;
+		if (PacketBatch::Split(packet, messages))
+		{
+			for (sf::Packet& message : messages)
+			{
+				HandlePacket(message);
+			}
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void NetworkGameState::SendJoinRequest()
+{
+	sf::Packet packet;
+	packet << static_cast<std::uint8_t>(PacketType::kJoinRequest) << NetworkConfig::kProtocolVersion;
+	Send(packet);
+}
+
+void NetworkGameState::SendInput()
+{
+	PlayerInput input;
+	input.tick = ++m_input_tick;
+	input.actions = static_cast<std::uint8_t>(m_player.SampleRealTimeActions() | m_pending_presses);
+	input.aim = GetAimDirection();
+	input.view_tick = m_interpolator.GetRenderTick();
+	m_pending_presses = 0;
+	//Predicted with exactly what the server will decode
+	InputCodec::Quantize(input);
+	m_input_buffer[input.tick % kInputBufferSize] = input;
+
+	//Newest first and always sent, then back to the oldest input the server hasn't acknowledged applying
+	std::array<PlayerInput, InputCodec::kMaxInputs> inputs;
+	int count = 0;
+	inputs[count++] = input;
+	for (std::uint32_t tick = m_input_tick - 1; tick > m_acknowledged_input && count < InputCodec::kMaxInputs; --tick)
+	{
+		inputs[count++] = m_input_buffer[tick % kInputBufferSize];
+	}
+	m_input_writer.Clear();
+	InputCodec::Write(m_input_writer, inputs.data(), count);
+
+	sf::Packet packet;
+	//Each input also acknowledges the newest snapshot, which the server then encodes deltas against
+	packet << static_cast<std::uint8_t>(PacketType::kInput) << m_has_snapshot << m_snapshot.tick;
+	m_input_writer.AppendTo(packet);
+	Send(packet);
+}
+
+void NetworkGameState::ReceiveRoundEvents()
+{
+	sf::Packet message;
+	while (m_channel.Receive(message))
+	{
+		RoundEvent event;
+		if (message >> event)
+		{
+			m_world.ApplyRoundEvent(event);
+		}
+	}
+}
+
+void NetworkGameState::ReplayUnacknowledgedInput(sf::Time dt)
+{
+	if (m_player_index < 0)
+		return;
+
+	//The snapshot already holds everything up to the acknowledged input, older entries have been overwritten in the ring
+	std::uint32_t first_tick = m_acknowledged_input + 1;
+	if (m_input_tick >= kInputBufferSize)
+	{
+		first_tick = std::max(first_tick, m_input_tick - kInputBufferSize + 1);
+	}
+
+	for (std::uint32_t tick = first_tick; tick < m_input_tick; ++tick)
+	{
+		m_world.PredictPlayer(m_player_index, m_player, m_input_buffer[tick % kInputBufferSize], dt);
+	}
+
+	//Only this tick's jump or landing is new, the replayed ones were heard when first predicted
+	if (Aircraft* aircraft = m_world.GetPlayerAircraft(m_player_index))
+	{
+		aircraft->ClearPendingMovementSounds();
+	}
+
+	if (m_input_tick > m_acknowledged_input)
+	{
+		m_world.PredictPlayer(m_player_index, m_player, m_input_buffer[m_input_tick % kInputBufferSize], dt);
+	}
+}
+
+void NetworkGameState::Send(sf::Packet& packet)
+{
+	if (!m_server_address)
+		return;
+
+	//Lost or refused datagrams are covered by the next one, inputs and joins are resent every tick anyway
+	static_cast<void>(m_link.Send(packet, *m_server_address, m_server_port));
+}
+
+sf::Vector2f NetworkGameState::GetAimDirection() const
+{
+	sf::Vector2f aim = m_player.GetJoystickAim();
+	const float kAimDeadzone = 0.2f;
+	if (std::hypot(aim.x, aim.y) > kAimDeadzone)
+		return aim;
+
+	if (m_player.GetJoystickId() < 0)
+		return m_world.GetAimDirectionToMouse(m_player_index);
+
+	//Zero keeps the current aim on the server
+	return { 0.f, 0.f };
+}
+
+void NetworkGameState::UpdateStatusText()
+{
+	if (m_player_index < 0)
+	{
+		m_status_text.setString("Connecting to " + NetworkConfig::GetInstance().GetHost() + ":" + std::to_string(m_server_port) + "...");
+	}
+	else if (m_connected_players < WorldSnapshot::kMaxPlayers)
+	{
+		m_status_text.setString("Waiting for an opponent (" + std::to_string(m_connected_players) + "/" + std::to_string(WorldSnapshot::kMaxPlayers) + ")");
+	}
+	else
+	{
+		m_status_text.setString("");
+	}
+}
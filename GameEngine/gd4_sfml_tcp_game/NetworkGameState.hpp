@@ -0,0 +1,92 @@
+#pragma once
+#include "State.hpp"
+#include "BitStream.hpp"
+#include "World.hpp"
+#include "Player.hpp"
+#include "WorldSnapshot.hpp"
+#include "SnapshotHistory.hpp"
+#include "SnapshotInterpolator.hpp"
+#include "NetworkConditioner.hpp"
+#include "ReliableChannel.hpp"
+#include "PlayerInput.hpp"
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+#include <SFML/System/Clock.hpp>
+#include <array>
+#include <cstdint>
+#include <optional>
+
+//Client side of a GameServer match: sends the local player's input every tick and mirrors the server's snapshots
+//The server is taken from NetworkConfig, set with --connect <host> [port]
+//The local aircraft is predicted: input moves it straight away and is replayed on top of every snapshot until the server acknowledges it
+class NetworkGameState : public State
+{
+public:
+	static const sf::Time kJoinRetryInterval;
+	static const sf::Time kServerTimeout;
+	//Two snapshot intervals behind the server, so one late or lost snapshot still leaves something to blend towards
+	static const sf::Time kInterpolationDelay;
+	static const sf::Time kMaxExtrapolation;
+	//About a second of input, a longer round trip than that can't be predicted anyway
+	static const std::uint32_t kInputBufferSize = 64;
+
+	NetworkGameState(StateStack& stack, Context context);
+	~NetworkGameState() override;
+	virtual void Draw() override;
+	virtual bool Update(sf::Time dt) override;
+	virtual bool HandleEvent(const sf::Event& event) override;
+
+private:
+	void ReceivePackets();
+	void HandlePacket(sf::Packet& packet);
+	void SendJoinRequest();
+	void SendInput();
+	void ReceiveRoundEvents();
+	void ReplayUnacknowledgedInput(sf::Time dt);
+	void Send(sf::Packet& packet);
+	sf::Vector2f GetAimDirection() const;
+	void UpdateStatusText();
+
+private:
+	World m_world;
+	Player m_player;
+	sf::UdpSocket m_socket;
+	NetworkConditioner m_link;
+	std::optional<sf::IpAddress> m_server_address;
+	unsigned short m_server_port;
+
+	//-1 until the server accepts the join and tells us which aircraft is ours
+	int m_player_index;
+	int m_connected_players;
+	bool m_disconnected;
+	sf::Time m_join_retry_timer;
+	sf::Time m_time_since_server;
+
+	unsigned int m_pending_presses;
+	std::uint32_t m_input_tick;
+	//Ring of sent input indexed by tick % kInputBufferSize, everything after m_acknowledged_input is still to be confirmed
+	std::array<PlayerInput, kInputBufferSize> m_input_buffer;
+	std::uint32_t m_acknowledged_input;
+	//Every input packet repeats the unacknowledged inputs before it, so a lost packet costs no input
+	BitWriter m_input_writer;
+
+	//Snapshots are read into the incoming buffer and swapped in when newer than the one held
+	//Every decoded snapshot is kept in the history because the server may pick any of them as a delta baseline
+	WorldSnapshot m_snapshot;
+	WorldSnapshot m_incoming_snapshot;
+	SnapshotHistory m_snapshot_history;
+	bool m_has_snapshot;
+	bool m_has_new_snapshot;
+
+	//Everything but the predicted player is drawn from the interpolator, m_render_snapshot is sampled from it every tick
+	SnapshotInterpolator m_interpolator;
+	WorldSnapshot m_render_snapshot;
+
+	//Round results, scores and pickups from the server, which keeps resending them until we acknowledge
+	ReliableChannel m_channel;
+	sf::Clock m_clock;
+
+	sf::Text m_status_text;
+};
@@ -0,0 +1,77 @@
+#include "PacketBatch.hpp"
+#include "PacketType.hpp"
+#include <cstdint>
+
+namespace
+{
+	const std::size_t kTypeSize = sizeof(std::uint8_t);
+	const std::size_t kSizeFieldSize = sizeof(std::uint16_t);
+}
+
+PacketBatch::PacketBatch()
+	: m_count(0)
+{
+}
+
+bool PacketBatch::Add(const sf::Packet& message)
+{
+	const std::size_t header = m_count == 0 ? kTypeSize + kSizeFieldSize : kSizeFieldSize;
+	if (m_packet.getDataSize() + header + message.getDataSize() > kMaxDatagramSize)
+		return false;
+
+	if (m_count == 0)
+	{
+		m_packet << static_cast<std::uint8_t>(PacketType::kBatch);
+	}
+	m_packet << static_cast<std::uint16_t>(message.getDataSize());
+	m_packet.append(message.getData(), message.getDataSize());
+	++m_count;
+	return true;
+}
+
+bool PacketBatch::IsEmpty() const
+{
+	return m_count == 0;
+}
+
+void PacketBatch::Take(sf::Packet& datagram)
+{
+	datagram.clear();
+	if (m_count == 1)
+	{
+		//Not worth the framing, the receiver gets the message exactly as it was added
+		const std::byte* data = static_cast<const std::byte*>(m_packet.getData());
+		datagram.append(data + kTypeSize + kSizeFieldSize, m_packet.getDataSize() - kTypeSize - kSizeFieldSize);
+	}
+	else if (m_count > 1)
+	{
+		datagram.append(m_packet.getData(), m_packet.getDataSize());
+	}
+	//Keeps its storage for the next tick's batch
+	m_packet.clear();
+	m_count = 0;
+}
+
+bool PacketBatch::Split(const sf::Packet& datagram, std::vector<sf::Packet>& messages)
+{
+	messages.clear();
+	const std::uint8_t* data = static_cast<const std::uint8_t*>(datagram.getData());
+	const std::size_t size = datagram.getDataSize();
+
+	std::size_t offset = kTypeSize;
+	while (offset < size)
+	{
+		if (offset + kSizeFieldSize > size)
+			return false;
+		//Written by sf::Packet, so in network byte order
+		const std::size_t length = (static_cast<std::size_t>(data[offset]) << 8) | data[offset + 1];
+		offset += kSizeFieldSize;
+		if (offset + length > size)
+			return false;
+
+		messages.emplace_back();
+		messages.back().append(data + offset, length);
+		offset += length;
+	}
+	return true;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <SFML/Network/Packet.hpp>
+#include <cstddef>
+#include <vector>
+
+//Packs several messages for the same client into one kBatch datagram: the type byte, then every message as a 16 bit size and its bytes
+//A tick's snapshot, reliable resends and acks then cost one send instead of one each. A lone message goes out unwrapped
+class PacketBatch
+{
+public:
+	//Kept under the usual path MTU so a batch is never split into IP fragments
+	static const std::size_t kMaxDatagramSize = 1200;
+
+	PacketBatch();
+	//False when the message doesn't fit next to those already batched, Take them first. A message too big for an empty batch never fits
+	bool Add(const sf::Packet& message);
+	bool IsEmpty() const;
+	//Copies the batched messages into datagram and empties the batch
+	void Take(sf::Packet& datagram);
+
+	//Splits a kBatch datagram back into its messages, false if it was truncated
+	static bool Split(const sf::Packet& datagram, std::vector<sf::Packet>& messages);
+
+private:
+	sf::Packet m_packet;
+	std::size_t m_count;
+};
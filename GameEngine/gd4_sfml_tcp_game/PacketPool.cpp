@@ -0,0 +1,123 @@
+#include "PacketPool.hpp"
+#include <cassert>
+#include <utility>
+
+PacketPool::Entry::Entry(PacketPool& owner)
+	: pool(owner)
+	, packet()
+	, references(0)
+{
+}
+
+PacketPool::PacketPool(std::size_t count, std::size_t capacity)
+	: m_capacity(capacity)
+{
+	m_entries.reserve(count);
+	m_free.reserve(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		m_free.emplace_back(CreateEntry());
+	}
+}
+
+PooledPacket PacketPool::Acquire()
+{
+	Entry* entry = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_free.empty())
+		{
+			entry = CreateEntry();
+			//Room for it to come back to without the free list growing on the hot path
+			m_free.reserve(m_entries.size());
+		}
+		else
+		{
+			entry = m_free.back();
+			m_free.pop_back();
+		}
+	}
+	entry->packet.clear();
+	return PooledPacket(entry);
+}
+
+std::size_t PacketPool::GetSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_entries.size();
+}
+
+PacketPool::Entry* PacketPool::CreateEntry()
+{
+	m_entries.emplace_back(std::make_unique<Entry>(*this));
+	Entry* entry = m_entries.back().get();
+
+	//sf::Packet has no reserve, but clearing keeps what was appended allocated
+	const std::vector<std::byte> fill(m_capacity);
+	entry->packet.append(fill.data(), fill.size());
+	entry->packet.clear();
+	return entry;
+}
+
+void PacketPool::Release(Entry& entry)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_free.emplace_back(&entry);
+}
+
+PooledPacket::PooledPacket()
+	: m_entry(nullptr)
+{
+}
+
+PooledPacket::PooledPacket(PacketPool::Entry* entry)
+	: m_entry(entry)
+{
+	m_entry->references.store(1, std::memory_order_relaxed);
+}
+
+PooledPacket::PooledPacket(const PooledPacket& other)
+	: m_entry(other.m_entry)
+{
+	if (m_entry)
+	{
+		m_entry->references.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+PooledPacket::PooledPacket(PooledPacket&& other) noexcept
+	: m_entry(std::exchange(other.m_entry, nullptr))
+{
+}
+
+PooledPacket& PooledPacket::operator=(PooledPacket other) noexcept
+{
+	std::swap(m_entry, other.m_entry);
+	return *this;
+}
+
+PooledPacket::~PooledPacket()
+{
+	//The last one out hands the packet back, after every send that used it has finished
+	if (m_entry && m_entry->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		m_entry->pool.Release(*m_entry);
+	}
+}
+
+PooledPacket::operator bool() const
+{
+	return m_entry != nullptr;
+}
+
+sf::Packet& PooledPacket::operator*() const
+{
+	assert(m_entry);
+	return m_entry->packet;
+}
+
+sf::Packet* PooledPacket::operator->() const
+{
+	assert(m_entry);
+	return &m_entry->packet;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <SFML/Network/Packet.hpp>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class PooledPacket;
+
+//Packets handed out for sending and taken back once the last reference is gone, so the send path stops allocating once warmed up
+//A cleared sf::Packet keeps its storage, a packet that grew for a large snapshot stays that size for the next one
+//References may be dropped on any thread, the packet itself must not be written once it has been shared
+class PacketPool
+{
+public:
+	PacketPool(std::size_t count, std::size_t capacity);
+	PacketPool(const PacketPool&) = delete;
+	PacketPool& operator=(const PacketPool&) = delete;
+
+	//An empty packet. When every pooled one is in flight the pool grows rather than fail
+	PooledPacket Acquire();
+	std::size_t GetSize() const;
+
+private:
+	friend class PooledPacket;
+
+	struct Entry
+	{
+		Entry(PacketPool& owner);
+		PacketPool& pool;
+		sf::Packet packet;
+		std::atomic<int> references;
+	};
+
+private:
+	Entry* CreateEntry();
+	void Release(Entry& entry);
+
+private:
+	mutable std::mutex m_mutex;
+	std::vector<std::unique_ptr<Entry>> m_entries;
+	std::vector<Entry*> m_free;
+	std::size_t m_capacity;
+};
+
+//Counted reference to a packet from a PacketPool, copying it shares the packet instead of its bytes
+class PooledPacket
+{
+public:
+	PooledPacket();
+	PooledPacket(const PooledPacket& other);
+	PooledPacket(PooledPacket&& other) noexcept;
+	PooledPacket& operator=(PooledPacket other) noexcept;
+	~PooledPacket();
+
+	explicit operator bool() const;
+	sf::Packet& operator*() const;
+	sf::Packet* operator->() const;
+
+private:
+	friend class PacketPool;
+	explicit PooledPacket(PacketPool::Entry* entry);
+
+private:
+	PacketPool::Entry* m_entry;
+};
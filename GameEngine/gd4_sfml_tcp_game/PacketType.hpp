@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+//First byte of every datagram between GameServer and NetworkGameState
+enum class PacketType : std::uint8_t
+{
+	kJoinRequest,
+	kJoinAccepted,
+	kJoinRejected,
+	kInput,
+	kSnapshot,
+	kLeave,
+	//ReliableChannel datagram, round events from the server and acks from the client
+	kReliable,
+	//Several of the above for one client, see PacketBatch
+	kBatch
+};
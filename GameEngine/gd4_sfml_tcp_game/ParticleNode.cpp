@@ -12,7 +12,7 @@ namespace
 
 ParticleNode::ParticleNode(ParticleType type, const TextureHolder& textures)
     : SceneNode()
-    , m_texture(textures.Get(TextureID::kParticle))
+    , m_texture(textures.Contains(TextureID::kParticle) ? &textures.Get(TextureID::kParticle) : nullptr)
     , m_type(type)
     , m_vertex_array(sf::PrimitiveType::TriangleStrip)
     , m_needs_vertex_update(true)
@@ -64,7 +64,7 @@ void ParticleNode::DrawCurrent(sf::RenderTarget& target, sf::RenderStates states
     }
 
     //Apply particle texture
-    states.texture = &m_texture;
+    states.texture = m_texture;
 
     //Draw the vertices
     target.draw(m_vertex_array, states);
@@ -82,7 +82,7 @@ void ParticleNode::AddVertex(float worldX, float worldY, float texCoordX, float
 
 void ParticleNode::ComputeVertices() const
 {
-    sf::Vector2f size(m_texture.getSize());
+    sf::Vector2f size = m_texture ? sf::Vector2f(m_texture->getSize()) : sf::Vector2f();
     sf::Vector2f half = size / 2.f;
 
     m_vertex_array.clear();
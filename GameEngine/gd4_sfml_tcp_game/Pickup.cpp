@@ -28,7 +28,7 @@ namespace
 Pickup::Pickup(PickupType type, const TextureHolder& textures)
     : Entity(1)
     , m_type(type)
-    , m_sprite(textures.Get(Table[static_cast<int>(type)].m_texture), Table[static_cast<int>(type)].m_texture_rect)
+    , m_local_bounds(Utility::CentredBounds(Table[static_cast<int>(type)].m_texture_rect))
 {
 	//Debug output to verify correct initialization
 //    std::cout << "Pickup constructor: " << GetPickupName(type)
@@ -36,12 +36,17 @@ Pickup::Pickup(PickupType type, const TextureHolder& textures)
 //    std::cout << "  Texture ID: " << static_cast<int>(Table[static_cast<int>(type)].m_texture) << std::endl;
 //    
     
-    Utility::CentreOrigin(m_sprite);
+    if (textures.Contains(Table[static_cast<int>(type)].m_texture))
+    {
+        m_sprite.emplace(textures.Get(Table[static_cast<int>(type)].m_texture), Table[static_cast<int>(type)].m_texture_rect);
+        Utility::CentreOrigin(*m_sprite);
+    }
 
     //Apply physics
     SetUsePhysics(true);
     SetMass(1.f);
     SetLinearDrag(10.5f);
+    SetCanSleep(true);
 
     std::cout << "  Constructor completed!" << std::endl;
 }
@@ -53,7 +58,7 @@ unsigned int Pickup::GetCategory() const
 
 sf::FloatRect Pickup::GetBoundingRect() const
 {
-    return GetWorldTransform().transformRect(m_sprite.getGlobalBounds());
+    return GetWorldTransform().transformRect(m_local_bounds);
 }
 
 void Pickup::Apply(Aircraft& player) const
@@ -63,14 +68,20 @@ void Pickup::Apply(Aircraft& player) const
 
 void Pickup::DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
 {
-    target.draw(m_sprite, states);
+    if (m_sprite)
+    {
+        target.draw(*m_sprite, states);
+    }
 }
 
 void Pickup::UpdateCurrent(sf::Time dt, CommandQueue& commands)
 {
-    //Apply constant downward gravity
-    const float k_gravity = 980.f;
-    AddForce(sf::Vector2f(0.f, k_gravity * GetMass()));
+    //Apply constant downward gravity, a sleeping pickup stays where it settled
+    if (!IsAsleep())
+    {
+        const float k_gravity = 980.f;
+        AddForce(sf::Vector2f(0.f, k_gravity * GetMass()));
+    }
 
     Entity::UpdateCurrent(dt, commands);
 }
@@ -2,6 +2,7 @@
 #include "Entity.hpp"
 #include "PickupType.hpp"
 #include "ResourceIdentifiers.hpp"
+#include <optional>
 
 class Aircraft;
 
@@ -20,6 +21,7 @@ public:
 
 private:
 	PickupType m_type;
-	sf::Sprite m_sprite;
+	std::optional<sf::Sprite> m_sprite;
+	sf::FloatRect m_local_bounds;
 };
 
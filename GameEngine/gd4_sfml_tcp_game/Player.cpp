@@ -65,12 +65,24 @@ Player::Player(int player_id) : m_player_id(player_id), m_current_mission_status
 
 void Player::HandleEvent(const sf::Event& event, CommandQueue& command_queue)
 {
+    PushActions(GetEventActions(event), command_queue);
+}
+
+void Player::HandleRealTimeInput(CommandQueue& command_queue)
+{
+    PushActions(SampleRealTimeActions(), command_queue);
+}
+
+unsigned int Player::GetEventActions(const sf::Event& event) const
+{
+    unsigned int actions = 0;
+
     if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
     {
         auto found = m_key_binding.find(keyPressed->code);
         if (found != m_key_binding.end() && !IsRealTimeAction(found->second))
         {
-            command_queue.Push(m_action_binding[found->second]);
+            actions |= GetActionBit(found->second);
         }
     }
 
@@ -79,7 +91,7 @@ void Player::HandleEvent(const sf::Event& event, CommandQueue& command_queue)
         auto found = m_mouse_binding.find(static_cast<sf::Mouse::Button>(mousePressed->button));
         if (found != m_mouse_binding.end() && !IsRealTimeAction(found->second))
         {
-            command_queue.Push(m_action_binding[found->second]);
+            actions |= GetActionBit(found->second);
         }
     }
 
@@ -94,28 +106,31 @@ void Player::HandleEvent(const sf::Event& event, CommandQueue& command_queue)
             auto it = m_joystick_button_binding.find(joyButtonPressed->button);
             if (it != m_joystick_button_binding.end() && !IsRealTimeAction(it->second))
             {
-                command_queue.Push(m_action_binding[it->second]);
+                actions |= GetActionBit(it->second);
             }
         }
     }
+    return actions;
 }
 
-void Player::HandleRealTimeInput(CommandQueue& command_queue)
+unsigned int Player::SampleRealTimeActions() const
 {
+    unsigned int actions = 0;
+
     //Check if any of the key bindings are pressed
-    for (auto pair : m_key_binding)
+    for (const auto& pair : m_key_binding)
     {
         if (sf::Keyboard::isKeyPressed(pair.first) && IsRealTimeAction(pair.second))
         {
-            command_queue.Push(m_action_binding[pair.second]);
+            actions |= GetActionBit(pair.second);
         }
     }
 
-    for (auto pair : m_mouse_binding)
+    for (const auto& pair : m_mouse_binding)
     {
         if (sf::Mouse::isButtonPressed(pair.first) && IsRealTimeAction(pair.second))
         {
-            command_queue.Push(m_action_binding[pair.second]);
+            actions |= GetActionBit(pair.second);
         }
     }
 
@@ -128,12 +143,12 @@ void Player::HandleRealTimeInput(CommandQueue& command_queue)
         if (left_stick_position_x > m_joystick_deadzone)
         {
             if (IsRealTimeAction(Action::kMoveRight))
-                command_queue.Push(m_action_binding[Action::kMoveRight]);
+                actions |= GetActionBit(Action::kMoveRight);
         }
         else if (left_stick_position_x < -m_joystick_deadzone)
         {
             if (IsRealTimeAction(Action::kMoveLeft))
-                command_queue.Push(m_action_binding[Action::kMoveLeft]);
+                actions |= GetActionBit(Action::kMoveLeft);
         }
 
         for (const auto& pair : m_joystick_button_binding)
@@ -142,10 +157,38 @@ void Player::HandleRealTimeInput(CommandQueue& command_queue)
             Action action = pair.second;
             if (IsRealTimeAction(action) && sf::Joystick::isButtonPressed(static_cast<unsigned int>(m_joystick_id), button))
             {
-                command_queue.Push(m_action_binding[action]);
+                actions |= GetActionBit(action);
             }
         }
     }
+    return actions;
+}
+
+void Player::PushActions(unsigned int actions, CommandQueue& command_queue) const
+{
+    for (const auto& pair : m_action_binding)
+    {
+        if (actions & GetActionBit(pair.first))
+        {
+            command_queue.Push(pair.second);
+        }
+    }
+}
+
+void Player::ApplyActions(unsigned int actions, SceneNode& aircraft, sf::Time dt) const
+{
+    for (const auto& pair : m_action_binding)
+    {
+        if (actions & GetActionBit(pair.first))
+        {
+            pair.second.action(aircraft, dt);
+        }
+    }
+}
+
+unsigned int Player::GetActionBit(Action action)
+{
+    return 1u << static_cast<unsigned int>(action);
 }
 
 void Player::AssignKey(Action action, sf::Keyboard::Key key)
@@ -15,6 +15,16 @@ public:
 	void HandleEvent(const sf::Event& event, CommandQueue& command_queue);
 	void HandleRealTimeInput(CommandQueue& command_queue);
 
+	//Action masks have bit GetActionBit(action) set for each action, so input can be sent over the network and replayed
+	unsigned int GetEventActions(const sf::Event& event) const;
+	unsigned int SampleRealTimeActions() const;
+	void PushActions(unsigned int actions, CommandQueue& command_queue) const;
+	//Runs the bound actions straight on one aircraft, skipping the queue, so the client can predict and replay its own input
+	void ApplyActions(unsigned int actions, SceneNode& aircraft, sf::Time dt) const;
+	static unsigned int GetActionBit(Action action);
+	//Real time actions repeat every tick they are held, the others fire once per press
+	static bool IsRealTimeAction(Action action);
+
 	//keyboard inputs
 	void AssignKey(Action action, sf::Keyboard::Key key);
 	sf::Keyboard::Key GetAssignedKey(Action action) const;
@@ -36,7 +46,6 @@ public:
 
 private:
 	void InitialiseActions();
-	static bool IsRealTimeAction(Action action);
 
 private:
 	//Key bindings and action bindings for mouse and keyboard
@@ -9,16 +9,11 @@
  * Original implementation, modified/adapted by Michal Becmer (D00256088) for project requirements
  */
 
-//Singleton to store player binding configuration between states
+//Player binding configuration kept between states, owned by Application and reached through the state Context
+//Not a singleton, so nothing but the window's own states ever sees a player's device
 class PlayerBindingConfig
 {
 public:
-	static PlayerBindingConfig& GetInstance()
-	{
-		static PlayerBindingConfig instance;
-		return instance;
-	}
-
 	void SetPlayerDevice(int playerId, const InputDeviceInfo& device)
 	{
 		if (playerId >= 0 && playerId < kMaxPlayers)
@@ -57,9 +52,4 @@ public:
 private:
 	static constexpr int kMaxPlayers = 2;
 	std::array<std::optional<InputDeviceInfo>, kMaxPlayers> m_player_devices;
-
-	PlayerBindingConfig() = default;
-	~PlayerBindingConfig() = default;
-	PlayerBindingConfig(const PlayerBindingConfig&) = delete;
-	PlayerBindingConfig& operator=(const PlayerBindingConfig&) = delete;
 };
\ No newline at end of file
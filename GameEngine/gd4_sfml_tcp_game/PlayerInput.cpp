@@ -0,0 +1,5 @@
+#include "PlayerInput.hpp"
+
+PlayerInput::PlayerInput() : tick(0), actions(0), aim(0.f, 0.f), view_tick(0)
+{
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+
+//One client tick of input, actions is a Player action mask and aim a unit direction (zero keeps the current aim)
+//view_tick is the server tick the client was drawing other players at, the server rewinds hit checks for its shots to then
+struct PlayerInput
+{
+	PlayerInput();
+	std::uint32_t tick;
+	std::uint8_t actions;
+	sf::Vector2f aim;
+	std::uint32_t view_tick;
+};
@@ -1,4 +1,5 @@
 #include "PostEffect.hpp"
+#include "TraceRecorder.hpp"
 #include <SFML/Graphics/Shader.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/VertexArray.hpp>
@@ -12,6 +13,7 @@ bool PostEffect::IsSupported()
 
 void PostEffect::ApplyShader(const sf::Shader& shader, sf::RenderTarget& output)
 {
+    ScopedTraceEvent trace("PostEffect::ApplyShader");
     sf::Vector2f output_size = static_cast<sf::Vector2f>(output.getSize());
     sf::VertexArray vertices(sf::PrimitiveType::TriangleStrip, 4);
     vertices[0] = sf::Vertex({ 0, 0 }, sf::Color::White, { 0, 1 });
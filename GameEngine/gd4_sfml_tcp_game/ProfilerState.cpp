@@ -0,0 +1,84 @@
+#include "ProfilerState.hpp"
+#include "FrameProfiler.hpp"
+#include "ResourceHolder.hpp"
+#include <SFML/Graphics/RenderWindow.hpp>
+
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+	//Rebuilding the text every frame would make the overlay show up in its own numbers
+	const sf::Time kRefreshInterval = sf::seconds(0.25f);
+}
+
+ProfilerState::ProfilerState(StateStack& stack, Context context)
+    : State(stack, context)
+    , m_background()
+    , m_profile_text(context.fonts->Get(Font::kMain))
+    , m_refresh_timer(kRefreshInterval)
+{
+    m_background.setFillColor(sf::Color(0, 0, 0, 170));
+    m_background.setPosition({ 5.f, 5.f });
+
+    m_profile_text.setCharacterSize(14);
+    m_profile_text.setFillColor(sf::Color::White);
+    m_profile_text.setPosition({ 10.f, 10.f });
+
+    UpdateText();
+}
+
+void ProfilerState::Draw()
+{
+    sf::RenderWindow& window = *GetContext().window;
+    window.setView(window.getDefaultView());
+
+    window.draw(m_background);
+    window.draw(m_profile_text);
+}
+
+bool ProfilerState::Update(sf::Time dt)
+{
+    m_refresh_timer += dt;
+    if (m_refresh_timer >= kRefreshInterval)
+    {
+        m_refresh_timer = sf::Time::Zero;
+        UpdateText();
+    }
+
+    //The overlay only observes, the game underneath keeps running
+    return true;
+}
+
+bool ProfilerState::HandleEvent(const sf::Event& event)
+{
+    if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
+    {
+        if (keyPressed->code == sf::Keyboard::Key::F3)
+        {
+            RequestStackPop();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ProfilerState::UpdateText()
+{
+    const FrameProfiler& profiler = *GetContext().profiler;
+
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(3);
+    stream << std::left << std::setw(14) << "Phase" << "   avg ms   worst ms\n";
+    for (int phase = 0; phase <= static_cast<int>(ProfilePhase::kPhaseCount); ++phase)
+    {
+        ProfilePhase profile_phase = static_cast<ProfilePhase>(phase);
+        stream << std::left << std::setw(14) << FrameProfiler::GetPhaseName(profile_phase) << std::right
+            << std::setw(9) << profiler.GetRollingAverageNanoseconds(profile_phase) / 1000000.0
+            << std::setw(11) << profiler.GetRollingWorstNanoseconds(profile_phase) / 1000000.0 << "\n";
+    }
+
+    m_profile_text.setString(stream.str());
+    sf::FloatRect bounds = m_profile_text.getLocalBounds();
+    m_background.setSize({ bounds.position.x + bounds.size.x + 10.f, bounds.position.y + bounds.size.y + 10.f });
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "State.hpp"
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/Text.hpp>
+
+//Overlay listing the rolling average and worst frame time of each World phase, toggled with F3 during a match
+class ProfilerState : public State
+{
+public:
+	ProfilerState(StateStack& stack, Context context);
+	virtual void Draw() override;
+	virtual bool Update(sf::Time dt) override;
+	virtual bool HandleEvent(const sf::Event& event) override;
+
+private:
+	void UpdateText();
+
+private:
+	sf::RectangleShape m_background;
+	sf::Text m_profile_text;
+	sf::Time m_refresh_timer;
+};
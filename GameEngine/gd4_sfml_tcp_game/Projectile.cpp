@@ -11,10 +11,13 @@ namespace
 }
 
 Projectile::Projectile(ProjectileType type, const TextureHolder& textures)
-    : Entity(1), m_type(type), m_sprite(textures.Get(Table[static_cast<int>(type)].m_texture)
-        , Table[static_cast<int>(type)].m_texture_rect), m_damage_multiplier(1.0f)
+    : Entity(1), m_type(type), m_damage_multiplier(1.0f)
 {
-    Utility::CentreOrigin(m_sprite);
+    if (textures.Contains(Table[static_cast<int>(type)].m_texture))
+    {
+        m_sprite.emplace(textures.Get(Table[static_cast<int>(type)].m_texture), Table[static_cast<int>(type)].m_texture_rect);
+        Utility::CentreOrigin(*m_sprite);
+    }
 
     SetUsePhysics(true);
 
@@ -25,7 +28,7 @@ Projectile::Projectile(ProjectileType type, const TextureHolder& textures)
     }
 
     //Add particle system for missiles
-    if (IsGuided())
+    if (IsGuided() && textures.Contains(TextureID::kParticle))
     {
         std::unique_ptr<EmitterNode> smoke(new EmitterNode(ParticleType::kSmoke));
         smoke->setPosition({ 0.f, GetBoundingRect().size.y / 2.f });
@@ -39,10 +42,13 @@ Projectile::Projectile(ProjectileType type, const TextureHolder& textures)
 Projectile::Projectile(ProjectileType type, const TextureHolder& textures, float damage_multiplier)
     : Entity(1)
     , m_type(type)
-    , m_sprite(textures.Get(Table[static_cast<int>(type)].m_texture), Table[static_cast<int>(type)].m_texture_rect)
     , m_damage_multiplier(damage_multiplier)
 {
-    Utility::CentreOrigin(m_sprite);
+    if (textures.Contains(Table[static_cast<int>(type)].m_texture))
+    {
+        m_sprite.emplace(textures.Get(Table[static_cast<int>(type)].m_texture), Table[static_cast<int>(type)].m_texture_rect);
+        Utility::CentreOrigin(*m_sprite);
+    }
 
     SetUsePhysics(true);
 
@@ -53,7 +59,7 @@ Projectile::Projectile(ProjectileType type, const TextureHolder& textures, float
     }
 
     //Add particle system for missiles
-    if (IsGuided())
+    if (IsGuided() && textures.Contains(TextureID::kParticle))
     {
         std::unique_ptr<EmitterNode> smoke(new EmitterNode(ParticleType::kSmoke));
         smoke->setPosition({ 0.f, GetBoundingRect().size.y / 2.f });
@@ -110,6 +116,21 @@ float Projectile::GetDamage() const
     return Table[static_cast<int>(m_type)].m_damage * m_damage_multiplier;
 }
 
+ProjectileType Projectile::GetProjectileType() const
+{
+    return m_type;
+}
+
+void Projectile::SetShooter(int player_id)
+{
+    m_shooter = player_id;
+}
+
+int Projectile::GetShooter() const
+{
+    return m_shooter;
+}
+
 void Projectile::UpdateCurrent(sf::Time dt, CommandQueue& commands)
 {
     if (IsGuided())
@@ -126,5 +147,8 @@ void Projectile::UpdateCurrent(sf::Time dt, CommandQueue& commands)
 
 void Projectile::DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
 {
-    target.draw(m_sprite, states);
+    if (m_sprite)
+    {
+        target.draw(*m_sprite, states);
+    }
 }
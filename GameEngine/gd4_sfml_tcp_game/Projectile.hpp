@@ -2,6 +2,7 @@
 #include "Entity.hpp"
 #include "ResourceIdentifiers.hpp"
 #include "ProjectileType.hpp"
+#include <optional>
 
 class Projectile : public Entity
 {
@@ -15,6 +16,10 @@ public:
 	sf::FloatRect GetBoundingRect() const override;
 	float GetMaxSpeed() const;
 	float GetDamage() const;
+	ProjectileType GetProjectileType() const;
+	//Player id of the aircraft that fired it, -1 for enemies and replicas
+	void SetShooter(int player_id);
+	int GetShooter() const;
 
 private:
 	virtual void UpdateCurrent(sf::Time dt, CommandQueue& commands) override;
@@ -22,8 +27,9 @@ private:
 
 private:
 	ProjectileType m_type;
-	sf::Sprite m_sprite;
+	std::optional<sf::Sprite> m_sprite;
 	sf::Vector2f m_target_direction;
 	float m_damage_multiplier;
+	int m_shooter = -1;
 };
 
@@ -0,0 +1,237 @@
+#include "ReliableChannel.hpp"
+#include <algorithm>
+
+namespace
+{
+	//Until the first ack has measured the round trip
+	const sf::Time kDefaultResendDelay = sf::seconds(0.2f);
+	//Acks ride on datagrams sent once a tick, resending much sooner than a round trip plus that would only duplicate
+	const sf::Time kMinResendDelay = sf::seconds(0.05f);
+	const float kResendRoundTrips = 1.5f;
+	const float kRoundTripSmoothing = 0.1f;
+	const int kAckBits = 32;
+
+	//Sequence numbers wrap, anything less than half the range ahead counts as newer
+	bool IsNewer(std::uint16_t a, std::uint16_t b)
+	{
+		return static_cast<std::int16_t>(static_cast<std::uint16_t>(a - b)) > 0;
+	}
+}
+
+ReliableChannel::ReliableChannel()
+	: m_next_sequence(0)
+	, m_next_message_id(0)
+	, m_outgoing()
+	, m_sent()
+	, m_has_received(false)
+	, m_remote_sequence(0)
+	, m_received_bits(0)
+	, m_ack_pending(false)
+	, m_next_receive_id(0)
+	, m_incoming()
+	, m_round_trip_time(sf::Time::Zero)
+{
+}
+
+void ReliableChannel::Send(const sf::Packet& message)
+{
+	const std::byte* bytes = static_cast<const std::byte*>(message.getData());
+	m_outgoing.push_back({ m_next_message_id++, false, false, sf::Time::Zero, std::vector<std::byte>(bytes, bytes + message.getDataSize()) });
+}
+
+bool ReliableChannel::Write(sf::Packet& datagram, sf::Time now)
+{
+	SentDatagram record{};
+	const sf::Time resend_delay = GetResendDelay();
+	for (OutgoingMessage& message : m_outgoing)
+	{
+		if (record.message_count == kMaxMessagesPerDatagram)
+			break;
+		//The queue is in id order, everything from here on is outside the receiver's window
+		if (static_cast<std::uint16_t>(message.id - m_outgoing.front().id) >= kWindowSize)
+			break;
+		if (message.acknowledged || (message.sent && now - message.last_sent < resend_delay))
+			continue;
+
+		message.sent = true;
+		message.last_sent = now;
+		record.message_ids[record.message_count++] = message.id;
+	}
+
+	if (record.message_count == 0 && !m_ack_pending)
+		return false;
+
+	record.valid = true;
+	record.sequence = m_next_sequence++;
+	record.time = now;
+	m_sent[record.sequence % kSentHistory] = record;
+	m_ack_pending = false;
+
+	datagram << record.sequence << m_has_received << m_remote_sequence << m_received_bits
+		<< static_cast<std::uint8_t>(record.message_count);
+	for (int i = 0; i < record.message_count; ++i)
+	{
+		const OutgoingMessage& message = m_outgoing[static_cast<std::uint16_t>(record.message_ids[i] - m_outgoing.front().id)];
+		datagram << message.id << static_cast<std::uint16_t>(message.data.size());
+		datagram.append(message.data.data(), message.data.size());
+	}
+	return true;
+}
+
+bool ReliableChannel::Read(sf::Packet& datagram, sf::Time now)
+{
+	std::uint16_t sequence = 0;
+	bool has_ack = false;
+	std::uint16_t ack = 0;
+	std::uint32_t ack_bits = 0;
+	std::uint8_t count = 0;
+	if (!(datagram >> sequence >> has_ack >> ack >> ack_bits >> count))
+		return false;
+
+	if (has_ack)
+	{
+		Acknowledge(ack, now);
+		for (int i = 0; i < kAckBits; ++i)
+		{
+			if (ack_bits & (1u << i))
+			{
+				Acknowledge(static_cast<std::uint16_t>(ack - 1 - i), now);
+			}
+		}
+	}
+
+	for (int i = 0; i < count; ++i)
+	{
+		std::uint16_t id = 0;
+		std::uint16_t size = 0;
+		if (!(datagram >> id >> size))
+			return false;
+
+		std::vector<std::byte> data(size);
+		for (std::byte& byte : data)
+		{
+			std::uint8_t value = 0;
+			datagram >> value;
+			byte = static_cast<std::byte>(value);
+		}
+		if (!datagram)
+			return false;
+
+		//Ids behind the next one expected were already delivered, a resend whose ack got lost
+		const std::uint16_t ahead = static_cast<std::uint16_t>(id - m_next_receive_id);
+		IncomingMessage& slot = m_incoming[id % kWindowSize];
+		if (ahead < kWindowSize && !(slot.received && slot.id == id))
+		{
+			slot.received = true;
+			slot.id = id;
+			slot.data = std::move(data);
+		}
+	}
+
+	//Only a datagram that was read in full is acknowledged, otherwise its messages would never be resent
+	RecordReceived(sequence);
+	if (count > 0)
+	{
+		m_ack_pending = true;
+	}
+	return true;
+}
+
+bool ReliableChannel::Receive(sf::Packet& message)
+{
+	IncomingMessage& slot = m_incoming[m_next_receive_id % kWindowSize];
+	if (!slot.received || slot.id != m_next_receive_id)
+		return false;
+
+	message.clear();
+	message.append(slot.data.data(), slot.data.size());
+	slot.received = false;
+	slot.data.clear();
+	++m_next_receive_id;
+	return true;
+}
+
+sf::Time ReliableChannel::GetRoundTripTime() const
+{
+	return m_round_trip_time;
+}
+
+void ReliableChannel::Acknowledge(std::uint16_t sequence, sf::Time now)
+{
+	SentDatagram& record = m_sent[sequence % kSentHistory];
+	if (!record.valid || record.sequence != sequence)
+		return;
+	record.valid = false;
+
+	const sf::Time sample = now - record.time;
+	if (m_round_trip_time == sf::Time::Zero)
+	{
+		m_round_trip_time = sample;
+	}
+	else
+	{
+		m_round_trip_time += (sample - m_round_trip_time) * kRoundTripSmoothing;
+	}
+
+	for (int i = 0; i < record.message_count; ++i)
+	{
+		AcknowledgeMessage(record.message_ids[i]);
+	}
+	while (!m_outgoing.empty() && m_outgoing.front().acknowledged)
+	{
+		m_outgoing.pop_front();
+	}
+}
+
+void ReliableChannel::AcknowledgeMessage(std::uint16_t id)
+{
+	if (m_outgoing.empty())
+		return;
+
+	const std::uint16_t index = static_cast<std::uint16_t>(id - m_outgoing.front().id);
+	if (index < m_outgoing.size())
+	{
+		m_outgoing[index].acknowledged = true;
+	}
+}
+
+void ReliableChannel::RecordReceived(std::uint16_t sequence)
+{
+	if (!m_has_received)
+	{
+		m_has_received = true;
+		m_remote_sequence = sequence;
+		m_received_bits = 0;
+		return;
+	}
+
+	if (IsNewer(sequence, m_remote_sequence))
+	{
+		//The previous newest becomes bit shift - 1
+		const int shift = static_cast<std::uint16_t>(sequence - m_remote_sequence);
+		if (shift < kAckBits)
+		{
+			m_received_bits = (m_received_bits << shift) | (1u << (shift - 1));
+		}
+		else
+		{
+			m_received_bits = shift == kAckBits ? 1u << (kAckBits - 1) : 0;
+		}
+		m_remote_sequence = sequence;
+	}
+	else
+	{
+		const int behind = static_cast<std::uint16_t>(m_remote_sequence - sequence);
+		if (behind >= 1 && behind <= kAckBits)
+		{
+			m_received_bits |= 1u << (behind - 1);
+		}
+	}
+}
+
+sf::Time ReliableChannel::GetResendDelay() const
+{
+	if (m_round_trip_time == sf::Time::Zero)
+		return kDefaultResendDelay;
+	return std::max(kMinResendDelay, m_round_trip_time * kResendRoundTrips);
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <SFML/Network/Packet.hpp>
+#include <SFML/System/Time.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+//Reliable ordered messages over UDP for events that must not be lost, snapshots stay unreliable next to it
+//Every datagram has a sequence number and acknowledges the newest one received plus a bitfield of the 32 before it
+//A message is resent on a timer until a datagram carrying it is acknowledged, the receiver hands messages out in send order
+//Only this channel waits for a lost message, snapshots and input keep flowing past it
+class ReliableChannel
+{
+public:
+	//Messages further ahead of the oldest unacknowledged one wait to be sent, so the receiver's buffer never overflows
+	static const int kWindowSize = 64;
+	static const int kMaxMessagesPerDatagram = 8;
+
+	ReliableChannel();
+	void Send(const sf::Packet& message);
+	//Appends the channel header and the messages due for (re)sending. False when there is neither a message due nor an ack owed
+	bool Write(sf::Packet& datagram, sf::Time now);
+	//Takes in the part written by Write on the other end. False for a truncated datagram
+	bool Read(sf::Packet& datagram, sf::Time now);
+	//Next message in send order, false while it hasn't arrived
+	bool Receive(sf::Packet& message);
+
+	sf::Time GetRoundTripTime() const;
+
+private:
+	struct OutgoingMessage
+	{
+		std::uint16_t id;
+		bool acknowledged;
+		bool sent;
+		sf::Time last_sent;
+		std::vector<std::byte> data;
+	};
+
+	struct SentDatagram
+	{
+		bool valid;
+		std::uint16_t sequence;
+		sf::Time time;
+		int message_count;
+		std::array<std::uint16_t, kMaxMessagesPerDatagram> message_ids;
+	};
+
+	struct IncomingMessage
+	{
+		bool received;
+		std::uint16_t id;
+		std::vector<std::byte> data;
+	};
+
+	static const int kSentHistory = 256;
+
+	void Acknowledge(std::uint16_t sequence, sf::Time now);
+	void AcknowledgeMessage(std::uint16_t id);
+	void RecordReceived(std::uint16_t sequence);
+	sf::Time GetResendDelay() const;
+
+private:
+	std::uint16_t m_next_sequence;
+	std::uint16_t m_next_message_id;
+	std::deque<OutgoingMessage> m_outgoing;
+	std::array<SentDatagram, kSentHistory> m_sent;
+
+	//Newest datagram sequence from the other end, bit n of m_received_bits is the one n + 1 before it
+	bool m_has_received;
+	std::uint16_t m_remote_sequence;
+	std::uint32_t m_received_bits;
+	//Datagrams with messages in them are acknowledged straight away, bare acks are not, or the two ends would ping-pong forever
+	bool m_ack_pending;
+
+	std::uint16_t m_next_receive_id;
+	std::array<IncomingMessage, kWindowSize> m_incoming;
+
+	sf::Time m_round_trip_time;
+};
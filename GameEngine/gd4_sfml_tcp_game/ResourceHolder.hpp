@@ -1,4 +1,5 @@
 #pragma once
+#include "TraceRecorder.hpp"
 #include <map>
 #include <memory>
 #include <string>
@@ -14,6 +15,7 @@ public:
 	void Load(Identifier id, const std::string& filename, const Parameter& second_param);
 	Resource& Get(Identifier id);
 	const Resource& Get(Identifier id) const;
+	bool Contains(Identifier id) const;
 
 
 private:
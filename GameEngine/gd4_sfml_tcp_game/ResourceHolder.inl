@@ -4,6 +4,7 @@
 template <typename Identifier, typename Resource>
 void ResourceHolder<Identifier, Resource>::Load(Identifier id, const std::string& filename)
 {
+	ScopedTraceEvent trace("ResourceHolder::Load", filename.c_str());
 	// Create and load resource
 	std::unique_ptr<Resource> resource(new Resource());
 	bool loaded = false;
@@ -35,10 +36,17 @@ const Resource& ResourceHolder<Identifier, Resource>::Get(Identifier id) const
 	return *found->second;
 }
 
+template <typename Identifier, typename Resource>
+bool ResourceHolder<Identifier, Resource>::Contains(Identifier id) const
+{
+	return m_resource_map.find(id) != m_resource_map.end();
+}
+
 template <typename Identifier, typename Resource>
 template <typename Parameter>
 void ResourceHolder<Identifier, Resource>::Load(Identifier id, const std::string& filename, const Parameter& second_param)
 {
+	ScopedTraceEvent trace("ResourceHolder::Load", filename.c_str());
 	std::unique_ptr<Resource> resource(new Resource());
 	if (!resource->loadFromFile(filename, second_param))
 		throw std::runtime_error("ResourceHolder::load - Failed to load " + filename);
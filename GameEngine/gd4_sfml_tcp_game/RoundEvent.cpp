@@ -0,0 +1,30 @@
+#include "RoundEvent.hpp"
+
+RoundEvent::RoundEvent() : type(Type::kRoundStarted), round(1), player(-1), pickup(PickupType::kHealthRefill), scores()
+{
+}
+
+sf::Packet& operator<<(sf::Packet& packet, const RoundEvent& event)
+{
+	packet << static_cast<std::uint8_t>(event.type) << event.round << event.player << static_cast<std::uint8_t>(event.pickup);
+	for (std::int32_t score : event.scores)
+	{
+		packet << score;
+	}
+	return packet;
+}
+
+sf::Packet& operator>>(sf::Packet& packet, RoundEvent& event)
+{
+	std::uint8_t type = 0;
+	std::uint8_t pickup = 0;
+	packet >> type >> event.round >> event.player >> pickup;
+	for (std::int32_t& score : event.scores)
+	{
+		packet >> score;
+	}
+
+	event.type = static_cast<RoundEvent::Type>(type);
+	event.pickup = static_cast<PickupType>(pickup);
+	return packet;
+}
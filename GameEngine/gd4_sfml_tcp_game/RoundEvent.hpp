@@ -0,0 +1,30 @@
+#pragma once
+#include "PickupType.hpp"
+#include "WorldSnapshot.hpp"
+#include <SFML/Network/Packet.hpp>
+#include <array>
+#include <cstdint>
+
+//A match result the server's World reports once and every client must see, sent on the reliable channel instead of in snapshots
+//player is the round winner for kRoundOver (-1 for a draw), the match winner for kGameOver and the collector for kPickupCollected
+//round and scores are always the state after the event, so a client applying them in order ends up where the server is
+struct RoundEvent
+{
+	enum class Type : std::uint8_t
+	{
+		kRoundOver,
+		kRoundStarted,
+		kGameOver,
+		kPickupCollected
+	};
+
+	RoundEvent();
+	Type type;
+	std::int32_t round;
+	std::int8_t player;
+	PickupType pickup;
+	std::array<std::int32_t, WorldSnapshot::kMaxPlayers> scores;
+};
+
+sf::Packet& operator<<(sf::Packet& packet, const RoundEvent& event);
+sf::Packet& operator>>(sf::Packet& packet, RoundEvent& event);
@@ -1,14 +1,26 @@
 #include "SceneNode.hpp"
 #include "Utility.hpp"
+#include "CollisionTable.hpp"
+#include "SpatialGrid.hpp"
+#include <algorithm>
 #include <cassert>
+#include <functional>
 
 SceneNode::SceneNode(ReceiverCategories category):m_children(), m_parent(nullptr), m_default_category(category)
+    , m_world_transform(), m_world_transform_dirty(true)
+    , m_previous_position(), m_has_previous_position(false)
+    , m_owned_category_index(), m_category_index(nullptr), m_removal_flagged(false)
 {
 }
 
 void SceneNode::AttachChild(Ptr child)
 {
     child->m_parent = this;
+    child->MarkTransformDirty();
+    if (m_category_index)
+    {
+        child->SetSubtreeCategoryIndex(m_category_index);
+    }
     //Homework: Understand this -> Cherno
     m_children.emplace_back(std::move(child));
 }
@@ -20,6 +32,13 @@ SceneNode::Ptr SceneNode::DetachChild(const SceneNode& node)
 
     Ptr result = std::move(*found);
     result->m_parent = nullptr;
+    result->MarkTransformDirty();
+    if (m_category_index)
+    {
+        result->FlagSubtreeForRemoval();
+        m_category_index->RemoveFlagged();
+        result->SetSubtreeCategoryIndex(nullptr);
+    }
     m_children.erase(found);
     return Ptr();
 }
@@ -35,18 +54,110 @@ sf::Vector2f SceneNode::GetWorldPosition() const
     return GetWorldTransform() * sf::Vector2f();
 }
 
-sf::Transform SceneNode::GetWorldTransform() const
+const sf::Transform& SceneNode::GetWorldTransform() const
+{
+    //Recomputed only after this node or one of its ancestors moved
+    if (m_world_transform_dirty)
+    {
+        m_world_transform = m_parent ? m_parent->GetWorldTransform() * getTransform() : getTransform();
+        m_world_transform_dirty = false;
+    }
+    return m_world_transform;
+}
+
+void SceneNode::setPosition(sf::Vector2f position)
+{
+    sf::Transformable::setPosition(position);
+    MarkTransformDirty();
+}
+
+void SceneNode::move(sf::Vector2f offset)
+{
+    sf::Transformable::move(offset);
+    MarkTransformDirty();
+}
+
+void SceneNode::setRotation(sf::Angle angle)
+{
+    sf::Transformable::setRotation(angle);
+    MarkTransformDirty();
+}
+
+void SceneNode::rotate(sf::Angle angle)
+{
+    sf::Transformable::rotate(angle);
+    MarkTransformDirty();
+}
+
+void SceneNode::setScale(sf::Vector2f factors)
+{
+    sf::Transformable::setScale(factors);
+    MarkTransformDirty();
+}
+
+void SceneNode::scale(sf::Vector2f factor)
+{
+    sf::Transformable::scale(factor);
+    MarkTransformDirty();
+}
+
+void SceneNode::setOrigin(sf::Vector2f origin)
+{
+    sf::Transformable::setOrigin(origin);
+    MarkTransformDirty();
+}
+
+void SceneNode::SaveInterpolationState()
 {
-    sf::Transform transform = sf::Transform::Identity;
-    for (const SceneNode* node = this; node != nullptr; node = node->m_parent)
+    SavePreviousPosition();
+    for (Ptr& child : m_children)
     {
-        transform = node->getTransform() * transform;
+        child->SaveInterpolationState();
     }
-    return transform;
+}
+
+void SceneNode::SavePreviousPosition()
+{
+    m_previous_position = getPosition();
+    m_has_previous_position = true;
+}
+
+void SceneNode::ResetInterpolation()
+{
+    SavePreviousPosition();
+}
+
+sf::Vector2f SceneNode::GetTickMotion() const
+{
+    if (!m_has_previous_position)
+        return { 0.f, 0.f };
+    return getPosition() - m_previous_position;
+}
+
+void SceneNode::DrawInterpolated(sf::RenderTarget& target, sf::RenderStates states, float alpha) const
+{
+    //Apply the tranform of the current node
+    states.transform *= GetInterpolatedTransform(alpha);
+    //Draw the node and its children with the changed transform
+    DrawCurrent(target, states);
+    DrawChildren(target, states, alpha);
+}
+
+void SceneNode::EnableCategoryIndex()
+{
+    assert(m_parent == nullptr);
+    m_owned_category_index = std::make_unique<CategoryIndex>();
+    SetSubtreeCategoryIndex(m_owned_category_index.get());
 }
 
 void SceneNode::OnCommand(const Command& command, sf::Time dt)
 {
+    if (m_owned_category_index)
+    {
+        m_owned_category_index->Dispatch(command, dt);
+        return;
+    }
+
     //Is this command for me? If it is execute
     //Regardless of answer forward to all of my children
     if (command.category & GetCategory())
@@ -77,12 +188,26 @@ void SceneNode::DrawBoundingRect(sf::RenderTarget& target, sf::RenderStates stat
     target.draw(shape);
 }
 
-void SceneNode::CheckSceneCollision(SceneNode& scene_graph, std::set<Pair>& collision_pairs)
+void SceneNode::CollectCollidables(SpatialGrid& grid, const CollisionTable& table)
 {
-    CheckNodeCollision(scene_graph, collision_pairs);
-    for (Ptr& child : scene_graph.m_children)
+    //Layers, particles, text and sound nodes have no collision response so they are skipped here
+    //Static nodes are in the World's StaticGeometry instead
+    const unsigned int category = GetCategory();
+    const unsigned int mask = IsAsleep() ? table.GetSleepingMask(category) : table.GetMask(category);
+    if (mask != 0 && !table.IsStatic(category) && !IsDestroyed())
     {
-        CheckSceneCollision(*child, collision_pairs);
+        sf::FloatRect rect = GetBoundingRect();
+        if (IsAsleep())
+        {
+            const float margin = CollisionTable::kSleepingMargin;
+            rect.position -= sf::Vector2f(margin, margin);
+            rect.size += sf::Vector2f(margin * 2.f, margin * 2.f);
+        }
+        grid.Insert(*this, rect, category, mask);
+    }
+    for (Ptr& child : m_children)
+    {
+        child->CollectCollidables(grid, table);
     }
 }
 
@@ -93,9 +218,67 @@ bool Collision(const SceneNode& lhs, const SceneNode& rhs)
 
 void SceneNode::RemoveWrecks()
 {
-    auto wreck_field_begin = std::remove_if(m_children.begin(), m_children.end(), std::mem_fn(&SceneNode::IsMarkedForRemoval));
+    if (!m_owned_category_index)
+    {
+        auto wreck_field_begin = std::remove_if(m_children.begin(), m_children.end(), std::mem_fn(&SceneNode::IsMarkedForRemoval));
+        m_children.erase(wreck_field_begin, m_children.end());
+        std::for_each(m_children.begin(), m_children.end(), std::mem_fn(&SceneNode::RemoveWrecks));
+        return;
+    }
+
+    //Indexed graphs have to drop wrecks from the index before the nodes are destroyed
+    FlagWrecks();
+    m_owned_category_index->RemoveFlagged();
+    EraseFlaggedChildren();
+}
+
+//Registers the subtree with index, or just forgets the old index when index is nullptr
+void SceneNode::SetSubtreeCategoryIndex(CategoryIndex* index)
+{
+    m_category_index = index;
+    m_removal_flagged = false;
+    if (index && GetCategory() != static_cast<unsigned int>(ReceiverCategories::kNone))
+    {
+        index->Add(*this);
+    }
+    for (Ptr& child : m_children)
+    {
+        child->SetSubtreeCategoryIndex(index);
+    }
+}
+
+void SceneNode::FlagSubtreeForRemoval()
+{
+    m_removal_flagged = true;
+    for (Ptr& child : m_children)
+    {
+        child->FlagSubtreeForRemoval();
+    }
+}
+
+void SceneNode::FlagWrecks()
+{
+    for (Ptr& child : m_children)
+    {
+        if (child->IsMarkedForRemoval())
+        {
+            child->FlagSubtreeForRemoval();
+        }
+        else
+        {
+            child->FlagWrecks();
+        }
+    }
+}
+
+void SceneNode::EraseFlaggedChildren()
+{
+    auto wreck_field_begin = std::remove_if(m_children.begin(), m_children.end(), [](const Ptr& child)
+        {
+            return child->m_removal_flagged;
+        });
     m_children.erase(wreck_field_begin, m_children.end());
-    std::for_each(m_children.begin(), m_children.end(), std::mem_fn(&SceneNode::RemoveWrecks));
+    std::for_each(m_children.begin(), m_children.end(), std::mem_fn(&SceneNode::EraseFlaggedChildren));
 }
 
 void SceneNode::UpdateCurrent(sf::Time dt, CommandQueue& commands)
@@ -113,12 +296,8 @@ void SceneNode::UpdateChildren(sf::Time dt, CommandQueue& commands)
 
 void SceneNode::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
-    //Apply the tranform of the current node
-    states.transform *= getTransform();
-    //Draw the node and its children with the changed transform
-    DrawCurrent(target, states);
-    DrawChildren(target, states);
-    sf::FloatRect rect = GetBoundingRect();
+    DrawInterpolated(target, states, 1.f);
+    //sf::FloatRect rect = GetBoundingRect();
     //DrawBoundingRect(target, states, rect);
 }
 
@@ -127,32 +306,38 @@ void SceneNode::DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) c
     //Do nothing
 }
 
-void SceneNode::DrawChildren(sf::RenderTarget& target, sf::RenderStates states) const
+void SceneNode::DrawChildren(sf::RenderTarget& target, sf::RenderStates states, float alpha) const
 {
     for (const Ptr& child : m_children)
     {
-        child->draw(target, states);
+        child->DrawInterpolated(target, states, alpha);
     }
 }
 
+sf::Transform SceneNode::GetInterpolatedTransform(float alpha) const
+{
+    //Nodes created during the last tick have nothing to blend from
+    if (!m_has_previous_position || alpha >= 1.f)
+        return getTransform();
+
+    //Only the translation is blended, so shift the current transform back towards the saved position
+    sf::Vector2f offset = (m_previous_position - getPosition()) * (1.f - alpha);
+    sf::Transform transform;
+    transform.translate(offset);
+    return transform * getTransform();
+}
+
 unsigned int SceneNode::GetCategory() const
 {
     return static_cast<unsigned int>(m_default_category);
 }
 
-void SceneNode::CheckNodeCollision(SceneNode& node, std::set<Pair>& collision_pairs)
+bool SceneNode::IsDestroyed() const
 {
-    if (this != &node && Collision(*this, node) && !IsDestroyed() && !node.IsDestroyed())
-    {
-        collision_pairs.insert(std::minmax(this, &node));
-    }
-    for (Ptr& child : m_children)
-    {
-        child->CheckNodeCollision(node, collision_pairs);
-    }
+    return false;
 }
 
-bool SceneNode::IsDestroyed() const
+bool SceneNode::IsAsleep() const
 {
     return false;
 }
@@ -162,6 +347,19 @@ bool SceneNode::IsMarkedForRemoval() const
     return IsDestroyed();
 }
 
+void SceneNode::MarkTransformDirty()
+{
+    //A dirty node always has a dirty subtree, so there is nothing left to do below it
+    if (m_world_transform_dirty)
+        return;
+
+    m_world_transform_dirty = true;
+    for (Ptr& child : m_children)
+    {
+        child->MarkTransformDirty();
+    }
+}
+
 float Distance(const SceneNode& lhs, const SceneNode& rhs)
 {
     return Utility::Length(lhs.GetWorldPosition() - rhs.GetWorldPosition());
@@ -4,10 +4,10 @@
 #include "ReceiverCategories.hpp"
 #include "CommandQueue.hpp"
 #include "Command.hpp"
+#include "CategoryIndex.hpp"
 
-#include <set>
-
-
+class CollisionTable;
+class SpatialGrid;
 
 class SceneNode : public sf::Transformable, public sf::Drawable
 {
@@ -23,14 +23,37 @@ public:
 	void Update(sf::Time dt, CommandQueue& commands);
 
 	sf::Vector2f GetWorldPosition() const;
-	sf::Transform GetWorldTransform() const;
+	const sf::Transform& GetWorldTransform() const;
+
+	//Hide the sf::Transformable setters so every change invalidates the cached world transform of this subtree
+	void setPosition(sf::Vector2f position);
+	void move(sf::Vector2f offset);
+	void setRotation(sf::Angle angle);
+	void rotate(sf::Angle angle);
+	void setScale(sf::Vector2f factors);
+	void scale(sf::Vector2f factor);
+	void setOrigin(sf::Vector2f origin);
 
+	//Remembers the positions of this subtree at the start of a tick so drawing can blend towards the new ones
+	void SaveInterpolationState();
+	//Same for this node alone, headless worlds only keep it for the nodes GetTickMotion is asked about
+	void SavePreviousPosition();
+	//Drops the blend for this node after a teleport such as a respawn
+	//Called on a node spawned mid tick, its first tick is measured from where it was placed
+	void ResetInterpolation();
+	//How far the node has moved since the start of the tick, zero after a reset
+	sf::Vector2f GetTickMotion() const;
+	//Draws the subtree alpha of the way from the saved positions to the current ones, alpha 1 draws the current state
+	void DrawInterpolated(sf::RenderTarget& target, sf::RenderStates states, float alpha) const;
+
+	//Called on the root: from then on OnCommand on this node only visits receivers of the command's category
+	void EnableCategoryIndex();
 	void OnCommand(const Command& command, sf::Time dt);
 
 	virtual sf::FloatRect GetBoundingRect() const;
 	void DrawBoundingRect(sf::RenderTarget& target, sf::RenderStates states, sf::FloatRect& rect) const;
 
-	void CheckSceneCollision(SceneNode& scene_graph, std::set<Pair>& collison_pairs);
+	void CollectCollidables(SpatialGrid& grid, const CollisionTable& table);
 	void RemoveWrecks();
 	virtual unsigned int GetCategory() const;
 
@@ -42,17 +65,36 @@ private:
 	//Do not be tempted to call this method Draw()
 	virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 	virtual void DrawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
-	void DrawChildren(sf::RenderTarget& target, sf::RenderStates states) const;
-	
+	void DrawChildren(sf::RenderTarget& target, sf::RenderStates states, float alpha) const;
+	sf::Transform GetInterpolatedTransform(float alpha) const;
 
-	void CheckNodeCollision(SceneNode& node, std::set<Pair>& collison_pairs);
 	virtual bool IsDestroyed() const;
+	//Sleeping nodes are left out of the broadphase tests against static solids
+	virtual bool IsAsleep() const;
 	virtual bool IsMarkedForRemoval() const;
+	void MarkTransformDirty();
+
+	void SetSubtreeCategoryIndex(CategoryIndex* index);
+	void FlagSubtreeForRemoval();
+	void FlagWrecks();
+	void EraseFlaggedChildren();
 
 private:
 	std::vector<Ptr> m_children;
 	SceneNode* m_parent;
 	ReceiverCategories m_default_category;
+
+	mutable sf::Transform m_world_transform;
+	mutable bool m_world_transform_dirty;
+
+	sf::Vector2f m_previous_position;
+	bool m_has_previous_position;
+
+	std::unique_ptr<CategoryIndex> m_owned_category_index;
+	CategoryIndex* m_category_index;
+	bool m_removal_flagged;
+
+	friend class CategoryIndex;
 };
 float Distance(const SceneNode& lhs, const SceneNode& rhs);
 bool Collision(const SceneNode& lhs, const SceneNode& rhs);
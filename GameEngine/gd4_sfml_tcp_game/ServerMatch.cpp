@@ -0,0 +1,108 @@
+#include "ServerMatch.hpp"
+#include "HitboxHistory.hpp"
+#include <algorithm>
+
+namespace
+{
+	unsigned int GetPressActionMask()
+	{
+		unsigned int mask = 0;
+		for (int i = 0; i < static_cast<int>(Action::kActionCount); ++i)
+		{
+			if (!Player::IsRealTimeAction(static_cast<Action>(i)))
+				mask |= Player::GetActionBit(static_cast<Action>(i));
+		}
+		return mask;
+	}
+}
+
+ServerMatch::ServerMatch(unsigned int seed)
+	: m_world()
+	, m_players{ { Player(0), Player(1) } }
+	, m_input_buffers()
+	, m_inputs()
+	, m_tick(0)
+{
+	m_world.SetRecordRoundEvents(true);
+	m_world.SetRandomSeed(seed);
+}
+
+void ServerMatch::SubmitInput(int player_index, const PlayerInput& input)
+{
+	if (player_index < 0 || player_index >= kMaxPlayers)
+		return;
+
+	static_cast<void>(m_input_buffers[player_index].Insert(input));
+}
+
+void ServerMatch::ResetPlayer(int player_index)
+{
+	if (player_index < 0 || player_index >= kMaxPlayers)
+		return;
+
+	m_input_buffers[player_index] = InputBuffer();
+	m_inputs[player_index] = PlayerInput();
+	//No view tick until the new client's first input arrives, its shots are checked against the present rather than the old client's view
+	m_world.SetPlayerRewind(player_index, 0);
+}
+
+void ServerMatch::Update(sf::Time dt)
+{
+	CommandQueue& commands = m_world.GetCommandQueue();
+	const unsigned int press_mask = GetPressActionMask();
+	for (int i = 0; i < kMaxPlayers; ++i)
+	{
+		//Without a new input the player keeps holding what they held, a press is only ever applied once
+		unsigned int actions = m_inputs[i].actions & ~press_mask;
+		PlayerInput input;
+		if (m_input_buffers[i].Pop(input, press_mask))
+		{
+			m_inputs[i] = input;
+			actions = input.actions;
+		}
+
+		m_players[i].PushActions(actions, commands);
+		m_world.SetPlayerAimDirection(i, m_inputs[i].aim);
+
+		//The player's shots hit whatever was where they saw it, as far back as the hitbox history goes
+		const std::uint32_t view_tick = m_inputs[i].view_tick;
+		const std::uint32_t rewind = (view_tick > 0 && view_tick < m_tick) ? m_tick - view_tick : 0;
+		m_world.SetPlayerRewind(i, static_cast<int>(std::min<std::uint32_t>(rewind, HitboxHistory::kCapacity - 1)));
+	}
+
+	m_world.Update(dt);
+	++m_tick;
+}
+
+void ServerMatch::CaptureSnapshot(WorldSnapshot& snapshot)
+{
+	m_world.CaptureSnapshot(snapshot);
+	snapshot.tick = m_tick;
+}
+
+void ServerMatch::TakeRoundEvents(std::vector<RoundEvent>& events)
+{
+	m_world.TakeRoundEvents(events);
+}
+
+RoundEvent ServerMatch::CaptureRoundState() const
+{
+	return m_world.CaptureRoundState();
+}
+
+std::uint32_t ServerMatch::GetTick() const
+{
+	return m_tick;
+}
+
+std::uint32_t ServerMatch::GetLastInputTick(int player_index) const
+{
+	if (player_index < 0 || player_index >= kMaxPlayers)
+		return 0;
+	return m_inputs[player_index].tick;
+}
+
+bool ServerMatch::IsFinished() const
+{
+	return m_world.ShouldReturnToMenu();
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "World.hpp"
+#include "InputBuffer.hpp"
+#include "Player.hpp"
+#include "PlayerInput.hpp"
+#include "RoundEvent.hpp"
+#include "WorldSnapshot.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+//One authoritative headless World and the remote inputs driving it, stepped by GameServer at its tick rate
+class ServerMatch
+{
+public:
+	static const int kMaxPlayers = WorldSnapshot::kMaxPlayers;
+
+	//Every match draws its random numbers from its own seed, matches hosted side by side share no state
+	explicit ServerMatch(unsigned int seed);
+	//Queued by tick, one input per player is applied each Update. Repeats of a tick already queued or applied are ignored
+	void SubmitInput(int player_index, const PlayerInput& input);
+	//A new client took the seat, its input ticks start again from 1 and nothing of the previous occupant's input carries over
+	void ResetPlayer(int player_index);
+	void Update(sf::Time dt);
+	void CaptureSnapshot(WorldSnapshot& snapshot);
+	//Round events raised since the last call, for every client's reliable channel
+	void TakeRoundEvents(std::vector<RoundEvent>& events);
+	RoundEvent CaptureRoundState() const;
+
+	std::uint32_t GetTick() const;
+	//The newest input tick applied, clients replay their prediction from the one after it
+	std::uint32_t GetLastInputTick(int player_index) const;
+	bool IsFinished() const;
+
+private:
+	World m_world;
+	std::array<Player, kMaxPlayers> m_players;
+	std::array<InputBuffer, kMaxPlayers> m_input_buffers;
+	//The input applied last, its held actions carry on through ticks whose input hasn't arrived
+	std::array<PlayerInput, kMaxPlayers> m_inputs;
+	std::uint32_t m_tick;
+};
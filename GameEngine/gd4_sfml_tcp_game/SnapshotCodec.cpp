@@ -0,0 +1,248 @@
+#include "SnapshotCodec.hpp"
+#include "PickupType.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	//The arena is 1280 square, positions get a generous margin for things flying off screen
+	const float kPositionMin = -1024.f;
+	const float kPositionStep = 1.f / 8.f;
+	const int kPositionBits = 15;
+
+	//Bullets travel at 1500, knockback can add more
+	const float kVelocityMin = -4096.f;
+	const float kVelocityStep = 1.f / 4.f;
+	const int kVelocityBits = 15;
+
+	const float kRotationMin = -180.f;
+	const float kRotationStep = 360.f / 1024.f;
+	const int kRotationBits = 10;
+
+	const int kHitpointBits = 10;
+	//Knockback lasts 0.2 seconds, the most a hit or edge bounce gives
+	const float kKnockbackStep = 1.f / 256.f;
+	const int kKnockbackBits = 7;
+	const int kPowerupBits = static_cast<int>(PickupType::kPickupCount);
+	const int kTypeBits = 2;
+	const int kSubtypeBits = 8;
+	const int kEntityCountBits = 16;
+	//Ids mostly climb in small steps, a gap of up to 16 costs 5 bits instead of 33
+	const int kSmallIdGapBits = 4;
+
+	std::uint32_t ClampToBits(std::int32_t value, int bits)
+	{
+		return static_cast<std::uint32_t>(std::clamp<std::int32_t>(value, 0, (1 << bits) - 1));
+	}
+
+	float WrapDegrees(float degrees)
+	{
+		float wrapped = std::fmod(degrees + 180.f, 360.f);
+		if (wrapped < 0.f)
+			wrapped += 360.f;
+		return wrapped - 180.f;
+	}
+
+	sf::Vector2f QuantizeVector(sf::Vector2f value, float min, float step, int bits)
+	{
+		return { BitWriter::Quantize(value.x, min, step, bits), BitWriter::Quantize(value.y, min, step, bits) };
+	}
+
+	void WriteVector(BitWriter& writer, sf::Vector2f value, float min, float step, int bits)
+	{
+		writer.WriteQuantized(value.x, min, step, bits);
+		writer.WriteQuantized(value.y, min, step, bits);
+	}
+
+	sf::Vector2f ReadVector(BitReader& reader, float min, float step, int bits)
+	{
+		float x = reader.ReadQuantized(min, step, bits);
+		float y = reader.ReadQuantized(min, step, bits);
+		return { x, y };
+	}
+}
+
+void SnapshotCodec::Quantize(WorldSnapshot& snapshot)
+{
+	std::sort(snapshot.entities.begin(), snapshot.entities.end(), [](const EntitySnapshot& a, const EntitySnapshot& b)
+		{
+			return a.network_id < b.network_id;
+		});
+
+	for (EntitySnapshot& entity : snapshot.entities)
+	{
+		entity.position = QuantizeVector(entity.position, kPositionMin, kPositionStep, kPositionBits);
+		entity.velocity = QuantizeVector(entity.velocity, kVelocityMin, kVelocityStep, kVelocityBits);
+		entity.hitpoints = static_cast<std::int32_t>(ClampToBits(entity.hitpoints, kHitpointBits));
+		if (entity.type == NetworkEntityType::kAircraft)
+		{
+			entity.gun_rotation = BitWriter::Quantize(WrapDegrees(entity.gun_rotation), kRotationMin, kRotationStep, kRotationBits);
+			entity.knockback_seconds = BitWriter::Quantize(entity.knockback_seconds, 0.f, kKnockbackStep, kKnockbackBits);
+		}
+		else
+		{
+			entity.gun_rotation = 0.f;
+			entity.powerups = 0;
+			entity.on_ground = false;
+			entity.knockback_seconds = 0.f;
+		}
+	}
+}
+
+void SnapshotCodec::Write(BitWriter& writer, const WorldSnapshot& snapshot, const WorldSnapshot* baseline)
+{
+	writer.Write(static_cast<std::uint32_t>(snapshot.entities.size()), kEntityCountBits);
+	std::uint32_t previous_id = 0;
+	for (const EntitySnapshot& entity : snapshot.entities)
+	{
+		WriteEntityId(writer, entity.network_id, previous_id);
+		previous_id = entity.network_id;
+		WriteEntity(writer, entity, baseline ? baseline->FindEntity(entity.network_id) : nullptr);
+	}
+}
+
+bool SnapshotCodec::Read(BitReader& reader, WorldSnapshot& snapshot, const WorldSnapshot* baseline)
+{
+	std::uint32_t count = reader.Read(kEntityCountBits);
+	snapshot.entities.clear();
+	std::uint32_t previous_id = 0;
+	for (std::uint32_t i = 0; i < count && reader.IsValid(); ++i)
+	{
+		EntitySnapshot entity;
+		entity.network_id = ReadEntityId(reader, previous_id);
+		previous_id = entity.network_id;
+		ReadEntity(reader, entity, baseline ? baseline->FindEntity(entity.network_id) : nullptr);
+		snapshot.entities.push_back(entity);
+	}
+	return reader.IsValid();
+}
+
+void SnapshotCodec::WriteEntity(BitWriter& writer, const EntitySnapshot& entity, const EntitySnapshot* baseline)
+{
+	const bool is_aircraft = entity.type == NetworkEntityType::kAircraft;
+
+	//New since the baseline: everything, unconditionally
+	if (!baseline)
+	{
+		writer.Write(static_cast<std::uint32_t>(entity.type), kTypeBits);
+		writer.Write(entity.subtype, kSubtypeBits);
+		WriteVector(writer, entity.position, kPositionMin, kPositionStep, kPositionBits);
+		WriteVector(writer, entity.velocity, kVelocityMin, kVelocityStep, kVelocityBits);
+		writer.Write(ClampToBits(entity.hitpoints, kHitpointBits), kHitpointBits);
+		if (is_aircraft)
+		{
+			writer.WriteQuantized(entity.gun_rotation, kRotationMin, kRotationStep, kRotationBits);
+			writer.Write(entity.powerups, kPowerupBits);
+			writer.WriteBool(entity.on_ground);
+			writer.WriteQuantized(entity.knockback_seconds, 0.f, kKnockbackStep, kKnockbackBits);
+		}
+		return;
+	}
+
+	//Known: a changed bit per field, values only for the fields that changed
+	const bool position_changed = entity.position != baseline->position;
+	const bool velocity_changed = entity.velocity != baseline->velocity;
+	const bool hitpoints_changed = entity.hitpoints != baseline->hitpoints;
+	const bool rotation_changed = is_aircraft && entity.gun_rotation != baseline->gun_rotation;
+	const bool powerups_changed = is_aircraft && entity.powerups != baseline->powerups;
+	const bool movement_changed = is_aircraft && (entity.on_ground != baseline->on_ground || entity.knockback_seconds != baseline->knockback_seconds);
+
+	const bool changed = position_changed || velocity_changed || hitpoints_changed || rotation_changed || powerups_changed || movement_changed;
+	writer.WriteBool(changed);
+	if (!changed)
+		return;
+
+	writer.WriteBool(position_changed);
+	if (position_changed)
+		WriteVector(writer, entity.position, kPositionMin, kPositionStep, kPositionBits);
+
+	writer.WriteBool(velocity_changed);
+	if (velocity_changed)
+		WriteVector(writer, entity.velocity, kVelocityMin, kVelocityStep, kVelocityBits);
+
+	writer.WriteBool(hitpoints_changed);
+	if (hitpoints_changed)
+		writer.Write(ClampToBits(entity.hitpoints, kHitpointBits), kHitpointBits);
+
+	if (is_aircraft)
+	{
+		writer.WriteBool(rotation_changed);
+		if (rotation_changed)
+			writer.WriteQuantized(entity.gun_rotation, kRotationMin, kRotationStep, kRotationBits);
+
+		writer.WriteBool(powerups_changed);
+		if (powerups_changed)
+			writer.Write(entity.powerups, kPowerupBits);
+
+		writer.WriteBool(movement_changed);
+		if (movement_changed)
+		{
+			writer.WriteBool(entity.on_ground);
+			writer.WriteQuantized(entity.knockback_seconds, 0.f, kKnockbackStep, kKnockbackBits);
+		}
+	}
+}
+
+void SnapshotCodec::ReadEntity(BitReader& reader, EntitySnapshot& entity, const EntitySnapshot* baseline)
+{
+	if (!baseline)
+	{
+		entity.type = static_cast<NetworkEntityType>(reader.Read(kTypeBits));
+		entity.subtype = static_cast<std::uint8_t>(reader.Read(kSubtypeBits));
+		entity.position = ReadVector(reader, kPositionMin, kPositionStep, kPositionBits);
+		entity.velocity = ReadVector(reader, kVelocityMin, kVelocityStep, kVelocityBits);
+		entity.hitpoints = static_cast<std::int32_t>(reader.Read(kHitpointBits));
+		if (entity.type == NetworkEntityType::kAircraft)
+		{
+			entity.gun_rotation = reader.ReadQuantized(kRotationMin, kRotationStep, kRotationBits);
+			entity.powerups = static_cast<std::uint8_t>(reader.Read(kPowerupBits));
+			entity.on_ground = reader.ReadBool();
+			entity.knockback_seconds = reader.ReadQuantized(0.f, kKnockbackStep, kKnockbackBits);
+		}
+		return;
+	}
+
+	std::uint32_t network_id = entity.network_id;
+	entity = *baseline;
+	entity.network_id = network_id;
+	if (!reader.ReadBool())
+		return;
+
+	if (reader.ReadBool())
+		entity.position = ReadVector(reader, kPositionMin, kPositionStep, kPositionBits);
+	if (reader.ReadBool())
+		entity.velocity = ReadVector(reader, kVelocityMin, kVelocityStep, kVelocityBits);
+	if (reader.ReadBool())
+		entity.hitpoints = static_cast<std::int32_t>(reader.Read(kHitpointBits));
+
+	if (entity.type == NetworkEntityType::kAircraft)
+	{
+		if (reader.ReadBool())
+			entity.gun_rotation = reader.ReadQuantized(kRotationMin, kRotationStep, kRotationBits);
+		if (reader.ReadBool())
+			entity.powerups = static_cast<std::uint8_t>(reader.Read(kPowerupBits));
+		if (reader.ReadBool())
+		{
+			entity.on_ground = reader.ReadBool();
+			entity.knockback_seconds = reader.ReadQuantized(0.f, kKnockbackStep, kKnockbackBits);
+		}
+	}
+}
+
+void SnapshotCodec::WriteEntityId(BitWriter& writer, std::uint32_t network_id, std::uint32_t previous_id)
+{
+	const std::uint32_t gap = network_id - previous_id;
+	const bool small_gap = network_id > previous_id && gap <= (1u << kSmallIdGapBits);
+	writer.WriteBool(small_gap);
+	if (small_gap)
+		writer.Write(gap - 1, kSmallIdGapBits);
+	else
+		writer.Write(network_id, 32);
+}
+
+std::uint32_t SnapshotCodec::ReadEntityId(BitReader& reader, std::uint32_t previous_id)
+{
+	if (reader.ReadBool())
+		return previous_id + reader.Read(kSmallIdGapBits) + 1;
+	return reader.Read(32);
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "BitStream.hpp"
+#include "WorldSnapshot.hpp"
+
+//Bit packed WorldSnapshot encoding with quantized floats, delta compressed against a snapshot the receiver already has
+//Entities unchanged since the baseline cost one bit, entities missing from the snapshot are gone
+class SnapshotCodec
+{
+public:
+	//Rounds every field to the value that survives encoding and sorts entities by id
+	//The server runs this before sending so the snapshot it keeps as a baseline matches what clients decode
+	static void Quantize(WorldSnapshot& snapshot);
+	//baseline is null for a full snapshot, otherwise the reader must pass the same baseline
+	static void Write(BitWriter& writer, const WorldSnapshot& snapshot, const WorldSnapshot* baseline);
+	//Leaves snapshot.tick alone, that travels in the packet header. Returns false for a truncated snapshot
+	static bool Read(BitReader& reader, WorldSnapshot& snapshot, const WorldSnapshot* baseline);
+
+private:
+	static void WriteEntity(BitWriter& writer, const EntitySnapshot& entity, const EntitySnapshot* baseline);
+	static void ReadEntity(BitReader& reader, EntitySnapshot& entity, const EntitySnapshot* baseline);
+	static void WriteEntityId(BitWriter& writer, std::uint32_t network_id, std::uint32_t previous_id);
+	static std::uint32_t ReadEntityId(BitReader& reader, std::uint32_t previous_id);
+};
@@ -0,0 +1,29 @@
+#include "SnapshotHistory.hpp"
+
+SnapshotHistory::SnapshotHistory() : m_entries()
+{
+}
+
+void SnapshotHistory::Store(const WorldSnapshot& snapshot)
+{
+	//Assigning into the slot reuses its entity vector, so a warmed up history stops allocating
+	Entry& entry = m_entries[snapshot.tick % kCapacity];
+	entry.snapshot = snapshot;
+	entry.valid = true;
+}
+
+const WorldSnapshot* SnapshotHistory::Find(std::uint32_t tick) const
+{
+	const Entry& entry = m_entries[tick % kCapacity];
+	if (entry.valid && entry.snapshot.tick == tick)
+		return &entry.snapshot;
+	return nullptr;
+}
+
+void SnapshotHistory::Clear()
+{
+	for (Entry& entry : m_entries)
+	{
+		entry.valid = false;
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "WorldSnapshot.hpp"
+#include <array>
+#include <cstdint>
+
+//The last kCapacity snapshots by tick, kept on both ends so deltas can be encoded and decoded against them
+class SnapshotHistory
+{
+public:
+	static const int kCapacity = 64;
+
+	SnapshotHistory();
+	void Store(const WorldSnapshot& snapshot);
+	//Null once the tick has been overwritten by a newer one, or if it was never stored
+	const WorldSnapshot* Find(std::uint32_t tick) const;
+	void Clear();
+
+private:
+	struct Entry
+	{
+		bool valid = false;
+		WorldSnapshot snapshot;
+	};
+
+private:
+	std::array<Entry, kCapacity> m_entries;
+};
@@ -0,0 +1,135 @@
+#include "SnapshotInterpolator.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	//How much of the drift between the render clock and the server's is corrected per frame
+	const double kClockCorrection = 0.05;
+	//Further out than this the clock jumps instead, after a stall or at the start of a round
+	const double kClockResyncTicks = 30.0;
+
+	float LerpAngle(float from, float to, float t)
+	{
+		float difference = std::fmod(to - from + 540.f, 360.f) - 180.f;
+		return from + difference * t;
+	}
+}
+
+SnapshotInterpolator::SnapshotInterpolator(sf::Time time_per_tick, sf::Time delay, sf::Time max_extrapolation)
+	: m_snapshots()
+	, m_newest(0)
+	, m_count(0)
+	, m_seconds_per_tick(time_per_tick.asSeconds())
+	, m_delay_ticks(delay / time_per_tick)
+	, m_max_extrapolation_ticks(max_extrapolation / time_per_tick)
+	, m_render_tick(0.0)
+	, m_time_since_newest(sf::Time::Zero)
+{
+}
+
+void SnapshotInterpolator::Push(const WorldSnapshot& snapshot)
+{
+	if (m_count > 0 && snapshot.tick <= GetSnapshot(0).tick)
+		return;
+
+	if (m_count == 0)
+	{
+		m_render_tick = static_cast<double>(snapshot.tick) - m_delay_ticks;
+	}
+
+	//Assigning into the slot reuses its entity vector
+	m_newest = (m_newest + 1) % kCapacity;
+	m_snapshots[m_newest] = snapshot;
+	if (m_count < kCapacity)
+	{
+		++m_count;
+	}
+	m_time_since_newest = sf::Time::Zero;
+}
+
+void SnapshotInterpolator::Update(sf::Time dt)
+{
+	if (m_count == 0)
+		return;
+
+	m_time_since_newest += dt;
+	m_render_tick += dt.asSeconds() / m_seconds_per_tick;
+
+	//Where the render clock should be if the newest snapshot had arrived exactly on time
+	const double target = GetSnapshot(0).tick + m_time_since_newest.asSeconds() / m_seconds_per_tick - m_delay_ticks;
+	const double error = target - m_render_tick;
+	if (std::abs(error) > kClockResyncTicks)
+	{
+		m_render_tick = target;
+	}
+	else
+	{
+		m_render_tick += error * kClockCorrection;
+	}
+}
+
+bool SnapshotInterpolator::Sample(WorldSnapshot& snapshot) const
+{
+	if (m_count == 0)
+		return false;
+
+	//Newest snapshot at or before the render time, and the one after it if there is one
+	int from_age = m_count - 1;
+	for (int age = 0; age < m_count; ++age)
+	{
+		if (GetSnapshot(age).tick <= m_render_tick)
+		{
+			from_age = age;
+			break;
+		}
+	}
+	const WorldSnapshot& from = GetSnapshot(from_age);
+	const WorldSnapshot* to = from_age > 0 ? &GetSnapshot(from_age - 1) : nullptr;
+
+	snapshot.tick = from.tick;
+
+	//Before the oldest snapshot there is nothing to blend from
+	const float ticks_past_from = std::max(0.f, static_cast<float>(m_render_tick - from.tick));
+	const float t = to ? std::min(1.f, ticks_past_from / static_cast<float>(to->tick - from.tick)) : 0.f;
+
+	//Entities exist from the first snapshot that has them until the first that doesn't, like on the server
+	snapshot.entities.clear();
+	for (const EntitySnapshot& entity : from.entities)
+	{
+		snapshot.entities.push_back(entity);
+		EntitySnapshot& sampled = snapshot.entities.back();
+
+		const EntitySnapshot* next = to ? to->FindEntity(entity.network_id) : nullptr;
+		if (next)
+		{
+			sampled.position = entity.position + (next->position - entity.position) * t;
+			sampled.velocity = entity.velocity + (next->velocity - entity.velocity) * t;
+			sampled.gun_rotation = LerpAngle(entity.gun_rotation, next->gun_rotation, t);
+		}
+		else
+		{
+			//Past the newest snapshot, or gone in the next one: carry on along the last known velocity for a while
+			Extrapolate(sampled, ticks_past_from);
+		}
+	}
+	return true;
+}
+
+std::uint32_t SnapshotInterpolator::GetRenderTick() const
+{
+	if (m_count == 0 || m_render_tick < 0.0)
+		return 0;
+	return static_cast<std::uint32_t>(m_render_tick);
+}
+
+const WorldSnapshot& SnapshotInterpolator::GetSnapshot(int age) const
+{
+	return m_snapshots[(m_newest - age + kCapacity) % kCapacity];
+}
+
+void SnapshotInterpolator::Extrapolate(EntitySnapshot& entity, float ticks) const
+{
+	const float capped_ticks = std::min(ticks, m_max_extrapolation_ticks);
+	entity.position += entity.velocity * (capped_ticks * m_seconds_per_tick);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "WorldSnapshot.hpp"
+#include <SFML/System/Time.hpp>
+#include <array>
+#include <cstdint>
+
+//Jitter buffer of the latest server snapshots, sampled a fixed delay behind the newest one
+//Remote entities are drawn between two real snapshots instead of jumping whenever one arrives, late packets extrapolate for a capped time
+//The render clock runs on local frame time and is only nudged towards the server's, so smoothing doesn't depend on the snapshot or frame rate
+class SnapshotInterpolator
+{
+public:
+	static const int kCapacity = 16;
+
+	SnapshotInterpolator(sf::Time time_per_tick, sf::Time delay, sf::Time max_extrapolation);
+	//Snapshots must arrive in tick order, NetworkGameState already drops older ones
+	void Push(const WorldSnapshot& snapshot);
+	void Update(sf::Time dt);
+	//Entities present at the render time. False until a snapshot has arrived
+	bool Sample(WorldSnapshot& snapshot) const;
+	//Whole server tick currently drawn, 0 until a snapshot has arrived
+	std::uint32_t GetRenderTick() const;
+
+private:
+	const WorldSnapshot& GetSnapshot(int age) const;
+	void Extrapolate(EntitySnapshot& entity, float ticks) const;
+
+private:
+	std::array<WorldSnapshot, kCapacity> m_snapshots;
+	int m_newest;
+	int m_count;
+
+	float m_seconds_per_tick;
+	float m_delay_ticks;
+	float m_max_extrapolation_ticks;
+
+	//Server tick being drawn, fractional
+	double m_render_tick;
+	sf::Time m_time_since_newest;
+};
@@ -0,0 +1,113 @@
+#include "SpatialGrid.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(const sf::FloatRect& bounds, float cell_size)
+	: m_bounds(bounds)
+	, m_cell_size(cell_size)
+	, m_columns(std::max(1, static_cast<int>(std::ceil(bounds.size.x / cell_size))))
+	, m_rows(std::max(1, static_cast<int>(std::ceil(bounds.size.y / cell_size))))
+	, m_cells(static_cast<std::size_t>(m_columns * m_rows))
+{
+	assert(cell_size > 0.f);
+}
+
+void SpatialGrid::Clear()
+{
+	//Keep the cell capacity around so steady state ticks do not allocate
+	m_entries.clear();
+	for (std::vector<std::uint32_t>& cell : m_cells)
+	{
+		cell.clear();
+	}
+}
+
+void SpatialGrid::Insert(SceneNode& node, const sf::FloatRect& rect, unsigned int category, unsigned int mask)
+{
+	const std::uint32_t index = static_cast<std::uint32_t>(m_entries.size());
+	m_entries.push_back({ &node, rect, category, mask });
+
+	//Anything outside the grid bounds is clamped into the border cells
+	const int min_x = CellX(rect.position.x);
+	const int max_x = CellX(rect.position.x + rect.size.x);
+	const int min_y = CellY(rect.position.y);
+	const int max_y = CellY(rect.position.y + rect.size.y);
+
+	for (int y = min_y; y <= max_y; ++y)
+	{
+		for (int x = min_x; x <= max_x; ++x)
+		{
+			m_cells[y * m_columns + x].push_back(index);
+		}
+	}
+}
+
+void SpatialGrid::FindPairs(std::vector<SceneNode::Pair>& pairs) const
+{
+	const std::size_t first_new = pairs.size();
+
+	for (int y = 0; y < m_rows; ++y)
+	{
+		for (int x = 0; x < m_columns; ++x)
+		{
+			const std::vector<std::uint32_t>& cell = m_cells[y * m_columns + x];
+			for (std::size_t i = 0; i < cell.size(); ++i)
+			{
+				const Entry& lhs = m_entries[cell[i]];
+				for (std::size_t j = i + 1; j < cell.size(); ++j)
+				{
+					const Entry& rhs = m_entries[cell[j]];
+					//A pair without a response is dropped before touching the rects
+					//Both masks are checked, a sleeping body's mask leaves out the static solids it rests on
+					if (!(lhs.m_mask & rhs.m_category) || !(rhs.m_mask & lhs.m_category))
+						continue;
+
+					std::optional<sf::FloatRect> overlap = lhs.m_rect.findIntersection(rhs.m_rect);
+					if (!overlap.has_value())
+						continue;
+
+					//Two rects can share several cells, only the cell holding the overlap's top left corner reports them
+					if (CellX(overlap->position.x) != x || CellY(overlap->position.y) != y)
+						continue;
+
+					pairs.push_back(std::minmax(lhs.m_node, rhs.m_node));
+				}
+			}
+		}
+	}
+
+	//Sorted by node address so collision responses run in the same order as a std::set<Pair> would give
+	std::sort(pairs.begin() + first_new, pairs.end());
+}
+
+void SpatialGrid::FindStaticPairs(const StaticGeometry& geometry, std::vector<SceneNode::Pair>& pairs) const
+{
+	const unsigned int static_categories = geometry.GetCategories();
+	for (const Entry& entry : m_entries)
+	{
+		if (entry.m_mask & static_categories)
+		{
+			geometry.FindPairs(*entry.m_node, entry.m_rect, entry.m_mask, pairs);
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+}
+
+std::size_t SpatialGrid::GetEntryCount() const
+{
+	return m_entries.size();
+}
+
+int SpatialGrid::CellX(float x) const
+{
+	const int cell = static_cast<int>(std::floor((x - m_bounds.position.x) / m_cell_size));
+	return std::clamp(cell, 0, m_columns - 1);
+}
+
+int SpatialGrid::CellY(float y) const
+{
+	const int cell = static_cast<int>(std::floor((y - m_bounds.position.y) / m_cell_size));
+	return std::clamp(cell, 0, m_rows - 1);
+}
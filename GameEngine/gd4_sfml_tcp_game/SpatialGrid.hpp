@@ -0,0 +1,44 @@
+#pragma once
+#include "SceneNode.hpp"
+#include "StaticGeometry.hpp"
+#include <SFML/Graphics/Rect.hpp>
+
+#include <cstdint>
+#include <vector>
+
+//Uniform grid broadphase, rebuilt every tick from the collidable entities in the scene
+class SpatialGrid
+{
+public:
+	SpatialGrid(const sf::FloatRect& bounds, float cell_size);
+
+	void Clear();
+	//mask is the categories the node collides with, see CollisionTable
+	void Insert(SceneNode& node, const sf::FloatRect& rect, unsigned int category, unsigned int mask);
+	//Appends every pair of inserted nodes whose masks accept each other and whose rects overlap, each pair once, sorted
+	void FindPairs(std::vector<SceneNode::Pair>& pairs) const;
+	//Appends every inserted node's overlaps with the static geometry its mask accepts, then sorts all of pairs again
+	void FindStaticPairs(const StaticGeometry& geometry, std::vector<SceneNode::Pair>& pairs) const;
+
+	std::size_t GetEntryCount() const;
+
+private:
+	struct Entry
+	{
+		SceneNode* m_node;
+		sf::FloatRect m_rect;
+		unsigned int m_category;
+		unsigned int m_mask;
+	};
+
+	int CellX(float x) const;
+	int CellY(float y) const;
+
+private:
+	sf::FloatRect m_bounds;
+	float m_cell_size;
+	int m_columns;
+	int m_rows;
+	std::vector<Entry> m_entries;
+	std::vector<std::vector<std::uint32_t>> m_cells;
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+//Bounded lock-free queue between exactly one producer thread and one consumer thread
+//The capacity is rounded up to a power of two, a full queue refuses the push and the caller decides what is lost
+template <typename T>
+class SpscQueue
+{
+public:
+	explicit SpscQueue(std::size_t capacity);
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	//Producer thread only
+	bool TryPush(T item);
+	//Consumer thread only, item is left alone when the queue is empty
+	bool TryPop(T& item);
+
+private:
+	std::vector<T> m_items;
+	std::size_t m_mask;
+	//Kept on separate cache lines so the two threads don't keep stealing each other's line
+	alignas(64) std::atomic<std::size_t> m_head;
+	alignas(64) std::atomic<std::size_t> m_tail;
+};
+
+#include "SpscQueue.inl"
@@ -0,0 +1,42 @@
+#include "SpscQueue.hpp"
+
+template <typename T>
+SpscQueue<T>::SpscQueue(std::size_t capacity)
+	: m_items()
+	, m_mask(0)
+	, m_head(0)
+	, m_tail(0)
+{
+	std::size_t size = 1;
+	while (size < capacity)
+	{
+		size <<= 1;
+	}
+	m_items.resize(size);
+	m_mask = size - 1;
+}
+
+template <typename T>
+bool SpscQueue<T>::TryPush(T item)
+{
+	//Only the producer writes the tail, the head is the consumer's progress
+	const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+	if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+		return false;
+
+	m_items[tail & m_mask] = std::move(item);
+	m_tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::TryPop(T& item)
+{
+	const std::size_t head = m_head.load(std::memory_order_relaxed);
+	if (head == m_tail.load(std::memory_order_acquire))
+		return false;
+
+	item = std::move(m_items[head & m_mask]);
+	m_head.store(head + 1, std::memory_order_release);
+	return true;
+}
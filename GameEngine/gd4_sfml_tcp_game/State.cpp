@@ -2,7 +2,7 @@
 #include "StateID.hpp"
 #include "StateStack.hpp"
 
-State::Context::Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts, Player& player, MusicPlayer& music, SoundPlayer& sounds) : window(&window), textures(&textures), fonts(&fonts), player(&player), music(&music), sounds(&sounds)
+State::Context::Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts, Player& player, MusicPlayer& music, SoundPlayer& sounds, FrameProfiler& profiler, PlayerBindingConfig& bindings) : window(&window), textures(&textures), fonts(&fonts), player(&player), music(&music), sounds(&sounds), profiler(&profiler), bindings(&bindings)
 {
 }
 
@@ -33,3 +33,8 @@ State::Context State::GetContext() const
 {
     return m_context;
 }
+
+float State::GetInterpolationAlpha() const
+{
+    return m_stack->GetInterpolationAlpha();
+}
@@ -13,6 +13,8 @@ namespace sf
 }
 
 class Player;
+class FrameProfiler;
+class PlayerBindingConfig;
 class StateStack;
 
 class State
@@ -22,13 +24,15 @@ public:
 
 	struct Context
 	{
-		Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts, Player& player, MusicPlayer& music, SoundPlayer& sounds);
+		Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts, Player& player, MusicPlayer& music, SoundPlayer& sounds, FrameProfiler& profiler, PlayerBindingConfig& bindings);
 		sf::RenderWindow* window;
 		TextureHolder* textures;
 		FontHolder* fonts;
 		Player* player;
 		MusicPlayer* music;
 		SoundPlayer* sounds;
+		FrameProfiler* profiler;
+		PlayerBindingConfig* bindings;
 	};
 
 public:
@@ -45,6 +49,7 @@ protected:
 	void RequestStackClear();
 
 	Context GetContext() const;
+	float GetInterpolationAlpha() const;
 
 private:
 	StateStack* m_stack;
@@ -8,5 +8,7 @@ enum class StateID
 	kPause,
 	kSettings,
 	kGameOver,
-	kBinding
+	kBinding,
+	kProfiler,
+	kNetworkGame
 };
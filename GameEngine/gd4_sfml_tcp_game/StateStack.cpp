@@ -2,14 +2,16 @@
 #include "StateID.hpp"
 #include <SFML/System/Time.hpp>
 #include <SFML/Window/Event.hpp>
+#include "TraceRecorder.hpp"
 #include <cassert>
 
-StateStack::StateStack(State::Context context) : m_context(context)
+StateStack::StateStack(State::Context context) : m_context(context), m_interpolation_alpha(1.f)
 {
 }
 
 void StateStack::Update(sf::Time dt)
 {
+    ScopedTraceEvent trace("StateStack::Update");
     for (auto itr = m_stack.rbegin(); itr != m_stack.rend(); ++itr)
     {
         if (!(*itr)->Update(dt))
@@ -20,8 +22,10 @@ void StateStack::Update(sf::Time dt)
     ApplyPendingChanges();
 }
 
-void StateStack::Draw()
+void StateStack::Draw(float interpolation_alpha)
 {
+    ScopedTraceEvent trace("StateStack::Draw");
+    m_interpolation_alpha = interpolation_alpha;
     for (State::Ptr& state : m_stack)
     {
         state->Draw();
@@ -60,6 +64,11 @@ bool StateStack::IsEmpty() const
     return m_stack.empty();
 }
 
+float StateStack::GetInterpolationAlpha() const
+{
+    return m_interpolation_alpha;
+}
+
 State::Ptr StateStack::CreateState(StateID state_id)
 {
     auto found = m_state_factory.find(state_id);
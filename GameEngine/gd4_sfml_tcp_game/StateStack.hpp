@@ -14,13 +14,15 @@ public:
 	template<typename T>
 	void RegisterState(StateID state_id);
 	void Update(sf::Time dt);
-	void Draw();
+	//interpolation_alpha is how far the render time is between the last two updates, states read it while drawing
+	void Draw(float interpolation_alpha = 1.f);
 	void HandleEvent(const sf::Event& event);
 
 	void PushState(StateID state_id);
 	void PopState();
 	void ClearStack();
 	bool IsEmpty() const;
+	float GetInterpolationAlpha() const;
 
 
 private:
@@ -40,6 +42,7 @@ private:
 	std::vector<PendingChange> m_pending_list;
 	State::Context m_context;
 	std::map<StateID, std::function<State::Ptr()>> m_state_factory;
+	float m_interpolation_alpha;
 };
 
 template<typename T>
@@ -0,0 +1,116 @@
+#include "StaticGeometry.hpp"
+#include "ContactSolver.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+StaticGeometry::StaticGeometry()
+	: m_categories(0)
+	, m_is_built(false)
+{
+}
+
+void StaticGeometry::Add(SceneNode& node, const sf::FloatRect& rect, unsigned int category)
+{
+	assert(!m_is_built);
+	m_entries.push_back({ &node, rect, category, 0.f });
+	m_categories |= category;
+}
+
+void StaticGeometry::Build()
+{
+	std::sort(m_entries.begin(), m_entries.end(), [](const Entry& lhs, const Entry& rhs)
+		{
+			return lhs.m_rect.position.x < rhs.m_rect.position.x;
+		});
+
+	float reach = 0.f;
+	for (std::size_t i = 0; i < m_entries.size(); ++i)
+	{
+		const float right = m_entries[i].m_rect.position.x + m_entries[i].m_rect.size.x;
+		reach = i == 0 ? right : std::max(reach, right);
+		m_entries[i].m_reach = reach;
+	}
+	m_is_built = true;
+}
+
+unsigned int StaticGeometry::GetCategories() const
+{
+	return m_categories;
+}
+
+std::size_t StaticGeometry::GetEntryCount() const
+{
+	return m_entries.size();
+}
+
+template <typename Visitor>
+void StaticGeometry::ForEachOverlap(const sf::FloatRect& rect, unsigned int mask, Visitor visitor) const
+{
+	assert(m_is_built);
+	if (!(mask & m_categories))
+		return;
+
+	//Entries from the first one starting at or past the query's right edge onwards can't overlap it
+	const float left = rect.position.x;
+	const float right = rect.position.x + rect.size.x;
+	auto end = std::lower_bound(m_entries.begin(), m_entries.end(), right, [](const Entry& entry, float x)
+		{
+			return entry.m_rect.position.x < x;
+		});
+
+	for (auto it = end; it != m_entries.begin();)
+	{
+		--it;
+		//Nothing from here back reaches past the query's left edge
+		if (it->m_reach <= left)
+			break;
+		if (!(it->m_category & mask))
+			continue;
+
+		//Same strict overlap test as sf::Rect::findIntersection
+		if (it->m_rect.position.x + it->m_rect.size.x > left
+			&& it->m_rect.position.y < rect.position.y + rect.size.y
+			&& it->m_rect.position.y + it->m_rect.size.y > rect.position.y)
+		{
+			visitor(*it);
+		}
+	}
+}
+
+void StaticGeometry::Query(const sf::FloatRect& rect, unsigned int mask, std::vector<const Entry*>& hits) const
+{
+	ForEachOverlap(rect, mask, [&hits](const Entry& entry)
+		{
+			hits.push_back(&entry);
+		});
+}
+
+const StaticGeometry::Entry* StaticGeometry::Sweep(const sf::FloatRect& rect, sf::Vector2f motion, unsigned int mask, float& time, sf::Vector2f& normal) const
+{
+	//Only entries inside the box covering the whole motion can be hit
+	const sf::Vector2f sweep_min{ std::min(rect.position.x, rect.position.x + motion.x), std::min(rect.position.y, rect.position.y + motion.y) };
+	const sf::FloatRect sweep_bounds{ sweep_min, rect.size + sf::Vector2f(std::abs(motion.x), std::abs(motion.y)) };
+
+	const Entry* hit = nullptr;
+	ForEachOverlap(sweep_bounds, mask, [&](const Entry& entry)
+		{
+			float entry_time = 0.f;
+			sf::Vector2f entry_normal;
+			if (ContactSolver::FindTimeOfImpact(rect, motion, entry.m_rect, entry_time, entry_normal) && (!hit || entry_time < time))
+			{
+				hit = &entry;
+				time = entry_time;
+				normal = entry_normal;
+			}
+		});
+	return hit;
+}
+
+void StaticGeometry::FindPairs(SceneNode& node, const sf::FloatRect& rect, unsigned int mask, std::vector<SceneNode::Pair>& pairs) const
+{
+	ForEachOverlap(rect, mask, [&node, &pairs](const Entry& entry)
+		{
+			pairs.push_back(std::minmax(&node, entry.m_node));
+		});
+}
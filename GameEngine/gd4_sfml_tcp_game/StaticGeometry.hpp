@@ -0,0 +1,46 @@
+#pragma once
+#include "SceneNode.hpp"
+#include <SFML/Graphics/Rect.hpp>
+
+#include <vector>
+
+//Scenery that never moves, registered once while the scene is built instead of going through the broadphase every tick
+//Entries are sorted by left edge, a query binary searches its right edge and walks back until nothing further left can reach it
+class StaticGeometry
+{
+public:
+	struct Entry
+	{
+		SceneNode* m_node;
+		sf::FloatRect m_rect;
+		unsigned int m_category;
+		//Furthest right edge of this entry and every entry sorted before it
+		float m_reach;
+	};
+
+	StaticGeometry();
+
+	//rect is the node's world rect, it is kept as is from here on
+	void Add(SceneNode& node, const sf::FloatRect& rect, unsigned int category);
+	//Sorts what was added, queries are only valid afterwards
+	void Build();
+	unsigned int GetCategories() const;
+	std::size_t GetEntryCount() const;
+
+	//Appends every entry in mask whose rect overlaps rect
+	void Query(const sf::FloatRect& rect, unsigned int mask, std::vector<const Entry*>& hits) const;
+	//Earliest entry in mask that rect runs into while moving by motion, null if it gets through untouched
+	//time and normal are those of ContactSolver::FindTimeOfImpact
+	const Entry* Sweep(const sf::FloatRect& rect, sf::Vector2f motion, unsigned int mask, float& time, sf::Vector2f& normal) const;
+	//Appends a pair of node and every entry in mask whose rect overlaps rect
+	void FindPairs(SceneNode& node, const sf::FloatRect& rect, unsigned int mask, std::vector<SceneNode::Pair>& pairs) const;
+
+private:
+	template <typename Visitor>
+	void ForEachOverlap(const sf::FloatRect& rect, unsigned int mask, Visitor visitor) const;
+
+private:
+	std::vector<Entry> m_entries;
+	unsigned int m_categories;
+	bool m_is_built;
+};
@@ -0,0 +1,172 @@
+#include "TraceRecorder.hpp"
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	struct TraceEvent
+	{
+		const char* m_name;
+		char m_detail[TraceRecorder::kDetailSize];
+		std::int64_t m_timestamp;
+		char m_phase;
+	};
+
+	struct ThreadBuffer
+	{
+		std::vector<TraceEvent> m_events;
+		std::size_t m_dropped;
+		int m_thread_id;
+	};
+
+	std::atomic<bool> recording{ false };
+	std::chrono::steady_clock::time_point recording_start;
+
+	//Only touched when a thread records its first event and when the trace is written
+	std::mutex registry_mutex;
+	std::vector<std::unique_ptr<ThreadBuffer>>& GetRegistry()
+	{
+		static std::vector<std::unique_ptr<ThreadBuffer>> registry;
+		return registry;
+	}
+
+	ThreadBuffer& GetThreadBuffer()
+	{
+		//The registry owns the buffer so its events survive the thread
+		thread_local ThreadBuffer* buffer = nullptr;
+		if (!buffer)
+		{
+			std::unique_ptr<ThreadBuffer> created(new ThreadBuffer());
+			created->m_events.reserve(TraceRecorder::kEventsPerThread);
+			created->m_dropped = 0;
+
+			std::lock_guard<std::mutex> lock(registry_mutex);
+			created->m_thread_id = static_cast<int>(GetRegistry().size());
+			buffer = created.get();
+			GetRegistry().push_back(std::move(created));
+		}
+		return *buffer;
+	}
+
+	void Record(char phase, const char* name, const char* detail)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+		if (buffer.m_events.size() == buffer.m_events.capacity())
+		{
+			++buffer.m_dropped;
+			return;
+		}
+
+		TraceEvent event;
+		event.m_name = name;
+		event.m_detail[0] = '\0';
+		if (detail)
+		{
+			std::strncpy(event.m_detail, detail, TraceRecorder::kDetailSize - 1);
+			event.m_detail[TraceRecorder::kDetailSize - 1] = '\0';
+		}
+		event.m_timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - recording_start).count();
+		event.m_phase = phase;
+		buffer.m_events.push_back(event);
+	}
+
+	void WriteEscaped(std::ostream& out, const char* text)
+	{
+		for (; *text; ++text)
+		{
+			if (*text == '"' || *text == '\\')
+				out << '\\';
+			out << *text;
+		}
+	}
+}
+
+void TraceRecorder::Start()
+{
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	for (std::unique_ptr<ThreadBuffer>& buffer : GetRegistry())
+	{
+		buffer->m_events.clear();
+		buffer->m_dropped = 0;
+	}
+	recording_start = std::chrono::steady_clock::now();
+	recording.store(true, std::memory_order_release);
+}
+
+bool TraceRecorder::Stop(const std::string& filename)
+{
+	recording.store(false, std::memory_order_release);
+
+	std::ofstream out(filename);
+	if (!out)
+		return false;
+
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	out << std::fixed << std::setprecision(3);
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	std::size_t dropped = 0;
+	for (const std::unique_ptr<ThreadBuffer>& buffer : GetRegistry())
+	{
+		dropped += buffer->m_dropped;
+		for (const TraceEvent& event : buffer->m_events)
+		{
+			out << (first ? "\n" : ",\n");
+			first = false;
+
+			//Trace-event timestamps are in microseconds
+			out << "{\"name\":\"";
+			WriteEscaped(out, event.m_name);
+			out << "\",\"ph\":\"" << event.m_phase << "\",\"ts\":" << event.m_timestamp / 1000.0
+				<< ",\"pid\":1,\"tid\":" << buffer->m_thread_id;
+			if (event.m_detail[0] != '\0')
+			{
+				out << ",\"args\":{\"detail\":\"";
+				WriteEscaped(out, event.m_detail);
+				out << "\"}";
+			}
+			out << "}";
+		}
+	}
+	out << "\n],\"otherData\":{\"droppedEvents\":" << dropped << "}}\n";
+	return static_cast<bool>(out);
+}
+
+bool TraceRecorder::IsRecording()
+{
+	return recording.load(std::memory_order_relaxed);
+}
+
+void TraceRecorder::Begin(const char* name, const char* detail)
+{
+	Record('B', name, detail);
+}
+
+void TraceRecorder::End(const char* name)
+{
+	Record('E', name, nullptr);
+}
+
+ScopedTraceEvent::ScopedTraceEvent(const char* name, const char* detail)
+	: m_name(name)
+	, m_recorded(TraceRecorder::IsRecording())
+{
+	if (m_recorded)
+	{
+		TraceRecorder::Begin(m_name, detail);
+	}
+}
+
+ScopedTraceEvent::~ScopedTraceEvent()
+{
+	//An event that was begun is always closed so the timeline stays balanced
+	if (m_recorded)
+	{
+		TraceRecorder::End(m_name);
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//Records begin/end events into per-thread buffers and writes them as Chrome trace-event JSON for chrome://tracing or Perfetto
+//Recording only appends to the calling thread's preallocated buffer, Stop must run once every recording thread has finished
+class TraceRecorder
+{
+public:
+	//Events each thread can hold, later events are dropped and counted
+	static const std::size_t kEventsPerThread = 1 << 18;
+	static const std::size_t kDetailSize = 48;
+
+public:
+	static void Start();
+	//Stops recording and writes every buffered event to filename, returns false if the file could not be written
+	static bool Stop(const std::string& filename);
+	static bool IsRecording();
+
+	//name must outlive the recording, string literals are expected. detail is copied and truncated to kDetailSize - 1
+	static void Begin(const char* name, const char* detail = nullptr);
+	static void End(const char* name);
+};
+
+//Emits a begin event on construction and the matching end event on destruction while recording
+class ScopedTraceEvent
+{
+public:
+	explicit ScopedTraceEvent(const char* name, const char* detail = nullptr);
+	~ScopedTraceEvent();
+
+	ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+	ScopedTraceEvent& operator=(const ScopedTraceEvent&) = delete;
+
+private:
+	const char* m_name;
+	bool m_recorded;
+};
@@ -3,17 +3,6 @@
 #include <math.h>
 
 
-namespace
-{
-	std::default_random_engine CreateRandomEngine()
-	{
-		auto seed = static_cast<unsigned long>(std::time(nullptr));
-		return std::default_random_engine(seed);
-	}
-	auto RandomEngine = CreateRandomEngine();
-}
-
-
 sf::Vector2f Utility::UnitVector(const sf::Vector2f& source)
 {
     float length = sqrt((source.x * source.x) + (source.y * source.y));
@@ -45,6 +34,13 @@ void Utility::CentreOrigin(Animation& animation)
 	animation.setOrigin({ std::floor(bounds.position.x + bounds.size.x / 2.f), std::floor(bounds.position.y + bounds.size.y / 2.f) });
 }
 
+//Local bounds of a sprite using texture_rect after CentreOrigin, without needing the texture itself
+sf::FloatRect Utility::CentredBounds(const sf::IntRect& texture_rect)
+{
+	sf::Vector2f size(static_cast<float>(texture_rect.size.x), static_cast<float>(texture_rect.size.y));
+	sf::Vector2f origin(std::floor(size.x / 2.f), std::floor(size.y / 2.f));
+	return sf::FloatRect(-origin, size);
+}
 
 std::string Utility::toString(sf::Keyboard::Key key)
 {
@@ -169,10 +165,16 @@ double Utility::ToDegrees(double angle)
 	return angle*(180/M_PI);
 }
 
-int Utility::RandomInt(int exclusive_max)
+int Utility::RandomInt(int exclusive_max, std::default_random_engine& engine)
 {
 	std::uniform_int_distribution<> distr(0, exclusive_max - 1);
-	return distr(RandomEngine);
+	return distr(engine);
+}
+
+float Utility::RandomFloat(float min, float max, std::default_random_engine& engine)
+{
+	std::uniform_real_distribution<float> distr(min, max);
+	return distr(engine);
 }
 
 int Utility::Length(sf::Vector2f vector)
@@ -10,10 +10,13 @@ class Utility
 		static void CentreOrigin(sf::Sprite& sprite);
 		static void CentreOrigin(sf::Text& text);
 		static void CentreOrigin(Animation& animation);
+		static sf::FloatRect CentredBounds(const sf::IntRect& texture_rect);
 		static std::string toString(sf::Keyboard::Key key);
 		static double ToRadians(int degrees);
 		static double ToDegrees(double angle);
-		static int RandomInt(int exclusive_max);
+		//There is no shared engine, each World and Aircraft owns one so matches hosted side by side never touch the same state
+		static int RandomInt(int exclusive_max, std::default_random_engine& engine);
+		static float RandomFloat(float min, float max, std::default_random_engine& engine);
 		static int Length(sf::Vector2f vector);
 };
 
@@ -0,0 +1,102 @@
+#include "WorkerPool.hpp"
+#include <algorithm>
+
+WorkerPool::WorkerPool(int thread_count)
+	: m_task(nullptr)
+	, m_task_count(0)
+	, m_next_task(0)
+	, m_batch(0)
+	, m_active_workers(0)
+	, m_stopping(false)
+{
+	if (thread_count <= 0)
+	{
+		thread_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+
+	//The caller works through the batch as well, so one thread fewer is started
+	for (int i = 1; i < thread_count; ++i)
+	{
+		m_threads.emplace_back(&WorkerPool::WorkerLoop, this);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_batch_ready.notify_all();
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+void WorkerPool::Run(int task_count, const std::function<void(int)>& task)
+{
+	if (task_count <= 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_task = &task;
+		m_task_count = task_count;
+		m_next_task = 0;
+		++m_batch;
+	}
+	m_batch_ready.notify_all();
+
+	RunTasks();
+
+	//Every index has been claimed, wait for the workers still finishing theirs
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_batch_done.wait(lock, [this]
+		{
+			return m_active_workers == 0;
+		});
+	m_task = nullptr;
+}
+
+int WorkerPool::GetThreadCount() const
+{
+	return static_cast<int>(m_threads.size()) + 1;
+}
+
+void WorkerPool::WorkerLoop()
+{
+	std::uint64_t finished_batch = 0;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_batch_ready.wait(lock, [this, finished_batch]
+			{
+				return m_stopping || m_batch != finished_batch;
+			});
+		if (m_stopping)
+			return;
+
+		//A worker waking after its batch was finished by the others simply finds no indices left
+		finished_batch = m_batch;
+		if (!m_task)
+			continue;
+
+		++m_active_workers;
+		lock.unlock();
+		RunTasks();
+		lock.lock();
+		if (--m_active_workers == 0)
+		{
+			m_batch_done.notify_one();
+		}
+	}
+}
+
+void WorkerPool::RunTasks()
+{
+	for (int i = m_next_task++; i < m_task_count; i = m_next_task++)
+	{
+		(*m_task)(i);
+	}
+}
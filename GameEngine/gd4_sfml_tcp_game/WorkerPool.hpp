@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Fixed set of threads that run one batch of independent tasks at a time, the calling thread joins in and blocks until the batch is done
+//GameServer steps every hosted match on it once per tick, so a task must only touch its own match
+class WorkerPool
+{
+public:
+	//thread_count includes the calling thread, 0 picks one per hardware thread
+	explicit WorkerPool(int thread_count = 0);
+	~WorkerPool();
+	//Calls task(i) once for every i below task_count
+	void Run(int task_count, const std::function<void(int)>& task);
+	int GetThreadCount() const;
+
+private:
+	void WorkerLoop();
+	void RunTasks();
+
+private:
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_batch_ready;
+	std::condition_variable m_batch_done;
+
+	//Batch state is written under the mutex before the workers are woken, task indices are then claimed without it
+	const std::function<void(int)>* m_task;
+	int m_task_count;
+	std::atomic<int> m_next_task;
+	std::uint64_t m_batch;
+	int m_active_workers;
+	bool m_stopping;
+};
@@ -6,6 +6,8 @@
 #include "Command.hpp"
 #include "Platform.hpp"
 #include "Box.hpp"
+#include "Player.hpp"
+#include <algorithm>
 #include <iostream>
 #include <ctime>  
 
@@ -22,17 +24,30 @@
  */
 
 World::World(sf::RenderTarget& output_target, FontHolder& font, SoundPlayer& sounds)
+	:World(&output_target, &font, &sounds)
+{
+}
+
+World::World()
+	:World(nullptr, nullptr, nullptr)
+{
+}
+
+World::World(sf::RenderTarget* output_target, FontHolder* font, SoundPlayer* sounds)
 	:m_target(output_target)
-	,m_camera(output_target.getDefaultView())
+	//Headless worlds use the same view size as the game window so camera bounds behave identically
+	,m_default_view(output_target ? output_target->getDefaultView() : sf::View(sf::FloatRect({ 0.f, 0.f }, { 1024.f, 768.f })))
+	,m_camera(m_default_view)
+	,m_previous_camera(m_default_view)
 	,m_textures()
-	,m_fonts(font)
+	,m_headless_fonts()
+	,m_fonts(font ? *font : m_headless_fonts)
 	,m_sounds(sounds)
 	,m_scenegraph(ReceiverCategories::kNone)
 	,m_scene_layers()
 	,m_world_bounds({ 0.f,0.f }, { 1280.f, 1280.f })
 	,m_spawn_position(m_world_bounds.size.x / 2.f, m_world_bounds.size.y - 300.f)
 	,m_scrollspeed(0.f)//Setting it to 0 since we don't want our players to move up automatically
-	,m_scene_texture({ m_target.getSize().x, m_target.getSize().y })
 	,m_player_scores(2, 0)//2 players, 0 points
 	,m_current_round(1)
 	,m_points_to_win(5)
@@ -53,10 +68,26 @@ World::World(sf::RenderTarget& output_target, FontHolder& font, SoundPlayer& sou
 	,m_current_zoom_level(1.0f)
 	,m_camera_state_saved(false)
 	,m_camera_play_bounds({ 50.f, 50.f }, { 1240.f, 1240.f })
+	,m_profiler(nullptr)
+	,m_collision_grid(m_world_bounds, 128.f)
+	,m_is_replica(false)
+	,m_next_network_id(1)
+	,m_prediction_solids_dirty(true)
+	,m_simulation_tick(0)
+	,m_hitbox_history()
+	,m_player_rewind_ticks()
+	,m_record_round_events(false)
+	,m_random(static_cast<unsigned int>(std::time(nullptr)))
 {
-	std::srand(static_cast<unsigned int>(std::time(nullptr)));
 
-	LoadTextures();
+	if (!IsHeadless())
+	{
+		m_scene_texture.emplace(m_target->getSize());
+		m_bloom_effect = std::make_unique<BloomEffect>();
+		m_chromatic_effect = std::make_unique<ChromaticAberrationEffect>();
+		m_screen_shake_effect = std::make_unique<ScreenShakeEffect>();
+		LoadTextures();
+	}
 	BuildScene();
 
 	m_camera.zoom(1.0f);
@@ -66,20 +97,37 @@ World::World(sf::RenderTarget& output_target, FontHolder& font, SoundPlayer& sou
 	m_player_spawn_positions.push_back({ 200.f, 0.f });
 	m_player_spawn_positions.push_back({ 1100.f, 0.f });
 
-	m_round_over_text.emplace(m_fonts.Get(Font::kMain), "", 80);
-	m_round_over_text->setFillColor(sf::Color::White);
-	m_round_over_text->setOutlineColor(sf::Color::Black);
-	m_round_over_text->setOutlineThickness(3.f);
+	if (!IsHeadless())
+	{
+		m_round_over_text.emplace(m_fonts.Get(Font::kMain), "", 80);
+		m_round_over_text->setFillColor(sf::Color::White);
+		m_round_over_text->setOutlineColor(sf::Color::Black);
+		m_round_over_text->setOutlineThickness(3.f);
 
-	m_round_countdown_text.emplace(m_fonts.Get(Font::kMain), "", 40);
-	m_round_countdown_text->setFillColor(sf::Color::White);
-	m_round_countdown_text->setOutlineColor(sf::Color::Black);
-	m_round_countdown_text->setOutlineThickness(2.f);
+		m_round_countdown_text.emplace(m_fonts.Get(Font::kMain), "", 40);
+		m_round_countdown_text->setFillColor(sf::Color::White);
+		m_round_countdown_text->setOutlineColor(sf::Color::Black);
+		m_round_countdown_text->setOutlineThickness(2.f);
+	}
 
 }
 
 void World::Update(sf::Time dt)
 {
+	ScopedTraceEvent trace("World::Update");
+	++m_simulation_tick;
+
+	//Draw blends from here to wherever this tick leaves things, nothing is drawn headless so only the swept bodies keep a start
+	if (IsHeadless())
+	{
+		SaveSweptPositions();
+	}
+	else
+	{
+		m_scenegraph.SaveInterpolationState();
+	}
+	m_previous_camera = m_camera;
+
 	if (m_game_over)
 	{
 		//Freeze camera during game over
@@ -97,6 +145,7 @@ void World::Update(sf::Time dt)
 
 	if (m_round_over)
 	{
+		ScopedPhaseTimer round_timer(m_profiler, ProfilePhase::kRoundLogic);
 		m_round_restart_timer += dt;
 		UpdateRoundOverlay();
 
@@ -113,7 +162,8 @@ void World::Update(sf::Time dt)
 			UpdateCameraZoom(dt);
 		}
 
-		if (m_round_restart_timer >= m_round_restart_delay)
+		//A replica waits for the server's next round to arrive in a snapshot
+		if (m_round_restart_timer >= m_round_restart_delay && !m_is_replica)
 		{
 			StartNewRound();
 		}
@@ -124,6 +174,12 @@ void World::Update(sf::Time dt)
 	UpdateScreenShake(dt);
 	UpdateCameraZoom(dt);
 
+	if (m_is_replica)
+	{
+		UpdateReplica(dt);
+		return;
+	}
+
 	m_pickup_spawn_timer += dt;
 	if (m_pickup_spawn_timer >= m_pickup_spawn_interval)
 	{
@@ -132,57 +188,60 @@ void World::Update(sf::Time dt)
 		//Randomized next spawn interval
 		float min_interval = 3.f;
 		float max_interval = 7.f;
-		float random_interval = min_interval + (static_cast<float>(std::rand()) / RAND_MAX) * (max_interval - min_interval);
+		float random_interval = Utility::RandomFloat(min_interval, max_interval, m_random);
 		m_pickup_spawn_interval = sf::seconds(random_interval);
 
 		m_pickup_spawn_timer = sf::Time::Zero;
 	}
 
 	{
-		Command gravity;
-		//Target only specific entity categories
-		gravity.category = static_cast<int>(ReceiverCategories::kAircraft) 
-			| static_cast<int>(ReceiverCategories::kProjectile)
-			| static_cast<int>(ReceiverCategories::kBox)
-			| static_cast<int>(ReceiverCategories::kPickup);
-
-		const float gravityAcceleration = 200.f * 9.81f;
-		gravity.action = DerivedAction<Entity>([gravityAcceleration](Entity& e, sf::Time)
-			{
-				if (e.IsUsingPhysics())
+		ScopedPhaseTimer forces_timer(m_profiler, ProfilePhase::kForces);
+		{
+			Command gravity;
+			//Target only specific entity categories
+			gravity.category = static_cast<int>(ReceiverCategories::kAircraft) 
+				| static_cast<int>(ReceiverCategories::kProjectile)
+				| static_cast<int>(ReceiverCategories::kBox)
+				| static_cast<int>(ReceiverCategories::kPickup);
+
+			const float gravityAcceleration = m_gravity_acceleration;
+			gravity.action = DerivedAction<Entity>([gravityAcceleration](Entity& e, sf::Time)
 				{
-					//F = m * g (downwards)
-					e.AddForce({ 0.f, gravityAcceleration * e.GetMass() });
-				}
-			});
-
-		m_scenegraph.OnCommand(gravity, dt);
-	}
+					if (e.IsUsingPhysics() && !e.IsAsleep())
+					{
+						//F = m * g (downwards)
+						e.AddForce({ 0.f, gravityAcceleration * e.GetMass() });
+					}
+				});
+
+			m_scenegraph.OnCommand(gravity, dt);
+		}
 
-	{
-		Command projectileGravity;
-		projectileGravity.category = static_cast<int>(ReceiverCategories::kProjectile);
+		{
+			Command projectileGravity;
+			projectileGravity.category = static_cast<int>(ReceiverCategories::kProjectile);
 
-		//Smaller gravity for bullets so they don't drop too fast
-		const float projectileGravityAcceleration = 5.f;
-		projectileGravity.action = DerivedAction<Entity>([projectileGravityAcceleration](Entity& e, sf::Time)
-			{
-				if (e.IsUsingPhysics())
+			//Smaller gravity for bullets so they don't drop too fast
+			const float projectileGravityAcceleration = 5.f;
+			projectileGravity.action = DerivedAction<Entity>([projectileGravityAcceleration](Entity& e, sf::Time)
 				{
-					e.AddForce({ 0.f, projectileGravityAcceleration * e.GetMass() });
-				}
-			});
+					if (e.IsUsingPhysics())
+					{
+						e.AddForce({ 0.f, projectileGravityAcceleration * e.GetMass() });
+					}
+				});
 
-		m_scenegraph.OnCommand(projectileGravity, dt);
-	}
+			m_scenegraph.OnCommand(projectileGravity, dt);
+		}
 
-	for (Aircraft* player : m_player_aircrafts)
-	{
-		if (player)
+		for (Aircraft* player : m_player_aircrafts)
 		{
-			sf::Vector2f playerVel = player->GetVelocity();
-			if (!player->IsKnockbackActive())
-				player->SetVelocity(0.f, playerVel.y);
+			if (player)
+			{
+				sf::Vector2f playerVel = player->GetVelocity();
+				if (!player->IsKnockbackActive())
+					player->SetVelocity(0.f, playerVel.y);
+			}
 		}
 	}
 
@@ -192,27 +251,76 @@ void World::Update(sf::Time dt)
 	AdaptPlayerVelocity();
 
 	//Forward commands to the scenegraph
-	while (!m_command_queue.IsEmpty())
 	{
-		m_scenegraph.OnCommand(m_command_queue.Pop(), dt);
+		ScopedPhaseTimer commands_timer(m_profiler, ProfilePhase::kCommands);
+		while (!m_command_queue.IsEmpty())
+		{
+			m_scenegraph.OnCommand(m_command_queue.Pop(), dt);
+		}
 	}
 
-	m_scenegraph.Update(dt, m_command_queue);
+	{
+		ScopedPhaseTimer update_timer(m_profiler, ProfilePhase::kSceneUpdate);
+		m_scenegraph.Update(dt, m_command_queue);
+	}
 
-	AdaptPlayerPosition();
-	HandleCollisions();
-	m_scenegraph.RemoveWrecks();
+	{
+		ScopedPhaseTimer adapt_timer(m_profiler, ProfilePhase::kPlayerAdapt);
+		AdaptPlayerPosition();
+	}
+	{
+		ScopedPhaseTimer collision_timer(m_profiler, ProfilePhase::kCollisions);
+		HandleCollisions();
+	}
+	{
+		ScopedPhaseTimer cleanup_timer(m_profiler, ProfilePhase::kCleanup);
+		m_scenegraph.RemoveWrecks();
+	}
+	RecordHitboxes();
 
-	m_scenegraph.Update(sf::Time::Zero, m_command_queue);
-	while (!m_command_queue.IsEmpty())
 	{
-		m_scenegraph.OnCommand(m_command_queue.Pop(), dt);
+		ScopedPhaseTimer late_commands_timer(m_profiler, ProfilePhase::kLateCommands);
+		m_scenegraph.Update(sf::Time::Zero, m_command_queue);
+		while (!m_command_queue.IsEmpty())
+		{
+			m_scenegraph.OnCommand(m_command_queue.Pop(), dt);
+		}
 	}
 
+	ScopedPhaseTimer round_timer(m_profiler, ProfilePhase::kRoundLogic);
 	CheckRoundEnd();
 	UpdateScoreDisplay();
 }
 
+void World::UpdateReplica(sf::Time dt)
+{
+	//Pickup spawns, forces, collisions and round results all come from the server
+	//Only local commands such as sounds run here, and the scene moves entities along their last known velocity
+	{
+		ScopedPhaseTimer commands_timer(m_profiler, ProfilePhase::kCommands);
+		while (!m_command_queue.IsEmpty())
+		{
+			m_scenegraph.OnCommand(m_command_queue.Pop(), dt);
+		}
+	}
+
+	{
+		ScopedPhaseTimer update_timer(m_profiler, ProfilePhase::kSceneUpdate);
+		m_scenegraph.Update(dt, m_command_queue);
+	}
+	{
+		ScopedPhaseTimer cleanup_timer(m_profiler, ProfilePhase::kCleanup);
+		m_scenegraph.RemoveWrecks();
+		m_prediction_solids_dirty = true;
+	}
+
+	while (!m_command_queue.IsEmpty())
+	{
+		m_scenegraph.OnCommand(m_command_queue.Pop(), dt);
+	}
+	UpdateScoreDisplay();
+}
+
 void World::UpdateCameraZoom(sf::Time dt)
 {
 	std::vector<Aircraft*> alive_players;
@@ -267,7 +375,7 @@ void World::UpdateCameraZoom(sf::Time dt)
 	float zoom_delta = target_zoom - m_current_zoom_level;
 	m_current_zoom_level += zoom_delta * m_zoom_speed * dt.asSeconds();
 
-	sf::Vector2f cameraSize = m_target.getDefaultView().getSize() * m_current_zoom_level;
+	sf::Vector2f cameraSize = m_default_view.getSize() * m_current_zoom_level;
 
 	float half_width = cameraSize.x / 2.f;
 	float half_height = cameraSize.y / 2.f;
@@ -277,7 +385,7 @@ void World::UpdateCameraZoom(sf::Time dt)
 	camera_target.y = std::max(m_camera_play_bounds.position.y + half_height,
 		std::min(camera_target.y, m_camera_play_bounds.position.y + m_camera_play_bounds.size.y - half_height));
 
-	m_camera = m_target.getDefaultView();
+	m_camera = m_default_view;
 	m_camera.zoom(m_current_zoom_level);
 
 	m_camera.setCenter(camera_target);
@@ -307,6 +415,16 @@ void World::CheckRoundEnd()
 		m_round_restart_timer = sf::Time::Zero;
 
 
+		if (alive_count == 1 && last_alive_player >= 0)
+		{
+			m_player_scores[last_alive_player]++;
+		}
+		RecordRoundEvent(RoundEvent::Type::kRoundOver, alive_count == 1 ? last_alive_player : -1);
+
+		//Headless worlds run a match per worker thread, the server reports the round through its events instead
+		if (IsHeadless())
+			return;
+
 		//Per player status
 		std::cout << "\n=== ROUND " << m_current_round << " OVER ===" << std::endl;
 		for (size_t i = 0; i < m_player_aircrafts.size(); ++i)
@@ -323,7 +441,6 @@ void World::CheckRoundEnd()
 
 		if (alive_count == 1 && last_alive_player >= 0)
 		{
-			m_player_scores[last_alive_player]++;
 			std::cout << "\nPlayer " << (last_alive_player + 1) << " WINS" << std::endl;
 		}
 		else
@@ -356,17 +473,21 @@ void World::StartNewRound()
 {
 	if (IsGameOver())
 	{
-		std::cout << "\n=== GAME OVER ===" << std::endl;
-		std::cout << "Final Scores:" << std::endl;
-		for (size_t i = 0; i < m_player_scores.size(); ++i)
+		if (!IsHeadless())
 		{
-			std::cout << "Player " << (i + 1) << ": " << m_player_scores[i] << " points" << std::endl;
+			std::cout << "\n=== GAME OVER ===" << std::endl;
+			std::cout << "Final Scores:" << std::endl;
+			for (size_t i = 0; i < m_player_scores.size(); ++i)
+			{
+				std::cout << "Player " << (i + 1) << ": " << m_player_scores[i] << " points" << std::endl;
+			}
+			std::cout << "=================\n" << std::endl;
 		}
-		std::cout << "=================\n" << std::endl;
 
 		//Set game over to true and don't start a new round
 		m_game_over = true;
 		m_game_over_timer = sf::Time::Zero;
+		RecordRoundEvent(RoundEvent::Type::kGameOver, GetWinner());
 		return;
 	}
 
@@ -374,6 +495,7 @@ void World::StartNewRound()
 	m_current_round++;
 	m_round_over = false;
 	m_camera_state_saved = false;
+	RecordRoundEvent(RoundEvent::Type::kRoundStarted, -1);
 
 	RespawnPlayers();
 	UpdateScoreDisplay();
@@ -401,6 +523,9 @@ void World::StartNewRound()
 
 void World::RespawnPlayers()
 {
+	//Nobody should be hit where they stood in the last round
+	m_hitbox_history.Clear();
+
 	//Respawn each player, reset health, position, velocity, and clear forces/knockback
 	for (size_t i = 0; i < m_player_aircrafts.size(); ++i)
 	{
@@ -416,13 +541,17 @@ void World::RespawnPlayers()
 		if (i < m_player_spawn_positions.size())
 		{
 			player->setPosition(m_player_spawn_positions[i]);
+			player->ResetInterpolation();
 		}
 
 		player->SetVelocity(0.f, 0.f);
 		player->ClearForces();
 		player->ClearKnockback();
 
-		std::cout << "Player " << (i + 1) << " respawned!" << std::endl;
+		if (!IsHeadless())
+		{
+			std::cout << "Player " << (i + 1) << " respawned!" << std::endl;
+		}
 	}
 }
 
@@ -480,6 +609,11 @@ int World::GetWinner() const
 	return -1;
 }
 
+bool World::IsHeadless() const
+{
+	return m_target == nullptr;
+}
+
 bool World::ShouldReturnToMenu() const
 {
 	return m_game_over && m_game_over_timer >= m_game_over_delay;
@@ -490,7 +624,7 @@ void World::UpdateRoundOverlay()
 	if (!m_round_over || !m_round_over_text.has_value() || !m_round_countdown_text.has_value())
 		return;
 
-	sf::Vector2f view_size = m_target.getDefaultView().getSize();
+	sf::Vector2f view_size = m_default_view.getSize();
 	sf::Vector2f view_center(view_size.x / 2.f, view_size.y / 2.f);
 
 	std::string message;
@@ -546,75 +680,97 @@ void World::UpdateRoundOverlay()
 	m_round_countdown_text->setPosition({ view_center.x, view_center.y + 50.f });//Fixed screen position
 }
 
-void World::Draw()
+void World::Draw(float alpha)
 {
+	ScopedTraceEvent trace("World::Draw");
+	if (IsHeadless())
+		return;
+
+	sf::RenderTarget& target = *m_target;
+	const sf::View camera = GetInterpolatedCamera(alpha);
+
 	if (PostEffect::IsSupported())
 	{
-		m_scene_texture.clear();
-		m_scene_texture.setView(m_camera);
-		m_scene_texture.draw(m_scenegraph);
-		m_scene_texture.display();
+		{
+			ScopedPhaseTimer scene_timer(m_profiler, ProfilePhase::kSceneDraw);
+			m_scene_texture->clear();
+			m_scene_texture->setView(camera);
+			m_scenegraph.DrawInterpolated(*m_scene_texture, sf::RenderStates::Default, alpha);
+			m_scene_texture->display();
+		}
 
+		ScopedPhaseTimer post_effects_timer(m_profiler, ProfilePhase::kPostEffects);
 		bool has_chromatic = m_damage_effect_intensity > 0.f;
 		bool has_shake = m_screen_shake_intensity > 0.f;
 
 		if (has_chromatic || has_shake)
 		{
 			sf::RenderTexture temp_texture;
-			if (!temp_texture.resize(m_target.getSize()))
+			if (!temp_texture.resize(target.getSize()))
 			{
 				//Fallback if resize fails
-				m_target.setView(m_camera);
-				m_target.draw(m_scenegraph);
+				target.setView(camera);
+				m_scenegraph.DrawInterpolated(target, sf::RenderStates::Default, alpha);
 				return;
 			}
 			temp_texture.clear();
 
 			if (has_chromatic && !has_shake)
 			{
-				m_chromatic_effect.SetIntensity(m_damage_effect_intensity);
-				m_chromatic_effect.Apply(m_scene_texture, m_target);
+				m_chromatic_effect->SetIntensity(m_damage_effect_intensity);
+				m_chromatic_effect->Apply(*m_scene_texture, target);
 			}
 			else if (has_shake && !has_chromatic)
 			{
-				m_screen_shake_effect.Apply(m_scene_texture, m_target);
+				m_screen_shake_effect->Apply(*m_scene_texture, target);
 			}
 			else
 			{
-				m_chromatic_effect.SetIntensity(m_damage_effect_intensity);
-				m_chromatic_effect.Apply(m_scene_texture, temp_texture);
+				m_chromatic_effect->SetIntensity(m_damage_effect_intensity);
+				m_chromatic_effect->Apply(*m_scene_texture, temp_texture);
 				temp_texture.display();
 
-				m_screen_shake_effect.Apply(temp_texture, m_target);
+				m_screen_shake_effect->Apply(temp_texture, target);
 			}
 		}
 		else
 		{
-			sf::Sprite sprite(m_scene_texture.getTexture());
-			m_target.draw(sprite);
+			sf::Sprite sprite(m_scene_texture->getTexture());
+			target.draw(sprite);
 		}
 	}
 	else
 	{
-		m_target.setView(m_camera);
-		m_target.draw(m_scenegraph);
+		ScopedPhaseTimer scene_timer(m_profiler, ProfilePhase::kSceneDraw);
+		target.setView(camera);
+		m_scenegraph.DrawInterpolated(target, sf::RenderStates::Default, alpha);
 	}
 
 	if (m_round_over && m_round_over_text.has_value() && m_round_countdown_text.has_value())
 	{
-		m_target.setView(m_target.getDefaultView());
+		ScopedPhaseTimer overlay_timer(m_profiler, ProfilePhase::kOverlayDraw);
+		target.setView(target.getDefaultView());
 
 		sf::RectangleShape backgroundShape;
 		backgroundShape.setFillColor(sf::Color(0, 0, 0, 150));
-		backgroundShape.setSize(m_target.getDefaultView().getSize());
+		backgroundShape.setSize(target.getDefaultView().getSize());
 		backgroundShape.setPosition({ 0.f, 0.f });
 
-		m_target.draw(backgroundShape);
-		m_target.draw(*m_round_over_text);
-		m_target.draw(*m_round_countdown_text);
+		target.draw(backgroundShape);
+		target.draw(*m_round_over_text);
+		target.draw(*m_round_countdown_text);
 	}
 }
 
+sf::View World::GetInterpolatedCamera(float alpha) const
+{
+	//The camera follows the players, so it has to be blended the same way or they would jitter against it
+	sf::View camera = m_camera;
+	camera.setCenter(m_previous_camera.getCenter() + (m_camera.getCenter() - m_previous_camera.getCenter()) * alpha);
+	camera.setSize(m_previous_camera.getSize() + (m_camera.getSize() - m_previous_camera.getSize()) * alpha);
+	return camera;
+}
+
 void World::TriggerDamageEffect()
 {
 	m_damage_effect_intensity = m_max_damage_intensity;
@@ -656,8 +812,11 @@ void World::UpdateScreenShake(sf::Time dt)
 		float progress = m_screen_shake_timer.asSeconds() / m_screen_shake_duration.asSeconds();
 		float current_intensity = m_screen_shake_intensity * (1.f - progress);
 
-		m_screen_shake_effect.SetIntensity(current_intensity);
-		m_screen_shake_effect.SetTime(m_screen_shake_time_accumulator.asSeconds());
+		if (m_screen_shake_effect)
+		{
+			m_screen_shake_effect->SetIntensity(current_intensity);
+			m_screen_shake_effect->SetTime(m_screen_shake_time_accumulator.asSeconds());
+		}
 
 		if (progress >= 1.f)
 		{
@@ -666,6 +825,417 @@ void World::UpdateScreenShake(sf::Time dt)
 	}
 }
 
+void World::SetProfiler(FrameProfiler* profiler)
+{
+	m_profiler = profiler;
+}
+
+void World::SetRandomSeed(unsigned int seed)
+{
+	//The players were built with the clock seeded engine, they draw their seeds again from the new one
+	m_random.seed(seed);
+	for (Aircraft* aircraft : m_player_aircrafts)
+	{
+		if (aircraft)
+		{
+			aircraft->SeedRandom(m_random());
+		}
+	}
+}
+
+void World::SpawnProjectile(ProjectileType type, sf::Vector2f position, sf::Vector2f velocity)
+{
+	std::unique_ptr<Projectile> projectile(new Projectile(type, m_textures));
+	projectile->setPosition(position);
+	projectile->SetVelocity(velocity);
+	projectile->ResetInterpolation();
+	m_scene_layers[static_cast<int>(SceneLayers::kLowerAir)]->AttachChild(std::move(projectile));
+}
+
+void World::SpawnBox(sf::Vector2f position)
+{
+	AddBox(position.x, position.y);
+}
+
+void World::SetReplica(bool replica)
+{
+	m_is_replica = replica;
+}
+
+bool World::IsReplica() const
+{
+	return m_is_replica;
+}
+
+void World::CaptureSnapshot(WorldSnapshot& snapshot)
+{
+	snapshot.entities.clear();
+
+	Command capture;
+	capture.category = static_cast<int>(ReceiverCategories::kAircraft)
+		| static_cast<int>(ReceiverCategories::kProjectile)
+		| static_cast<int>(ReceiverCategories::kBox)
+		| static_cast<int>(ReceiverCategories::kPickup);
+	capture.action = DerivedAction<Entity>([this, &snapshot](Entity& entity, sf::Time)
+		{
+			//Projectiles and pickups spawned since the last snapshot get their id here
+			if (entity.GetNetworkId() == 0)
+			{
+				RegisterNetworkEntity(entity);
+			}
+
+			EntitySnapshot state;
+			state.network_id = entity.GetNetworkId();
+			state.position = entity.getPosition();
+			state.velocity = entity.GetVelocity();
+			state.hitpoints = entity.GetHitPoints();
+
+			unsigned int category = entity.GetCategory();
+			if (category & static_cast<unsigned int>(ReceiverCategories::kAircraft))
+			{
+				const Aircraft& aircraft = static_cast<const Aircraft&>(entity);
+				state.type = NetworkEntityType::kAircraft;
+				state.subtype = static_cast<std::uint8_t>(aircraft.GetPlayerId());
+				state.gun_rotation = aircraft.GetGunRotation();
+				state.powerups = static_cast<std::uint8_t>(aircraft.GetActivePowerUpMask());
+				state.on_ground = aircraft.IsOnGround();
+				state.knockback_seconds = aircraft.GetRemainingKnockbackDuration().asSeconds();
+			}
+			else if (category & static_cast<unsigned int>(ReceiverCategories::kProjectile))
+			{
+				state.type = NetworkEntityType::kProjectile;
+				state.subtype = static_cast<std::uint8_t>(static_cast<const Projectile&>(entity).GetProjectileType());
+			}
+			else if (category & static_cast<unsigned int>(ReceiverCategories::kPickup))
+			{
+				state.type = NetworkEntityType::kPickup;
+				state.subtype = static_cast<std::uint8_t>(static_cast<const Pickup&>(entity).GetPickupType());
+			}
+			else
+			{
+				state.type = NetworkEntityType::kBox;
+			}
+			snapshot.entities.push_back(state);
+		});
+	m_scenegraph.OnCommand(capture, sf::Time::Zero);
+}
+
+void World::ApplySnapshot(const WorldSnapshot& snapshot)
+{
+	//Index the replicas currently in the graph, whatever is left unmatched afterwards is gone on the server
+	m_network_entities.clear();
+	Command index;
+	index.category = static_cast<int>(ReceiverCategories::kAircraft)
+		| static_cast<int>(ReceiverCategories::kProjectile)
+		| static_cast<int>(ReceiverCategories::kBox)
+		| static_cast<int>(ReceiverCategories::kPickup);
+	index.action = DerivedAction<Entity>([this](Entity& entity, sf::Time)
+		{
+			if (entity.GetNetworkId() != 0)
+			{
+				m_network_entities[entity.GetNetworkId()] = &entity;
+			}
+		});
+	m_scenegraph.OnCommand(index, sf::Time::Zero);
+
+	for (const EntitySnapshot& state : snapshot.entities)
+	{
+		Entity* entity = nullptr;
+		auto found = m_network_entities.find(state.network_id);
+		if (found != m_network_entities.end())
+		{
+			entity = found->second;
+			m_network_entities.erase(found);
+		}
+		else
+		{
+			entity = CreateReplica(state);
+			if (!entity)
+				continue;
+		}
+
+		//The predicted player only takes the newest state, in ResetPredictedPlayer
+		if (!entity->IsLocallyPredicted())
+		{
+			ApplyEntityState(*entity, state);
+		}
+	}
+
+	for (auto& pair : m_network_entities)
+	{
+		pair.second->Destroy();
+	}
+	m_network_entities.clear();
+	m_prediction_solids_dirty = true;
+}
+
+void World::SetRecordRoundEvents(bool record)
+{
+	m_record_round_events = record;
+	m_round_events.clear();
+}
+
+void World::TakeRoundEvents(std::vector<RoundEvent>& events)
+{
+	events.clear();
+	std::swap(events, m_round_events);
+}
+
+RoundEvent World::CaptureRoundState() const
+{
+	RoundEvent state;
+	state.type = m_game_over ? RoundEvent::Type::kGameOver : m_round_over ? RoundEvent::Type::kRoundOver : RoundEvent::Type::kRoundStarted;
+	state.round = m_current_round;
+	state.player = static_cast<std::int8_t>(m_game_over ? GetWinner() : -1);
+	for (int i = 0; i < WorldSnapshot::kMaxPlayers; ++i)
+	{
+		state.scores[i] = GetPlayerScore(i);
+	}
+	return state;
+}
+
+void World::ApplyRoundEvent(const RoundEvent& event)
+{
+	m_current_round = event.round;
+	for (int i = 0; i < WorldSnapshot::kMaxPlayers && i < static_cast<int>(m_player_scores.size()); ++i)
+	{
+		m_player_scores[i] = event.scores[i];
+	}
+
+	//The countdowns run locally from when the event arrives, the server's next event ends them
+	switch (event.type)
+	{
+	case RoundEvent::Type::kRoundOver:
+		m_round_over = true;
+		m_round_restart_timer = sf::Time::Zero;
+		break;
+	case RoundEvent::Type::kRoundStarted:
+		m_round_over = false;
+		m_camera_state_saved = false;
+		break;
+	case RoundEvent::Type::kGameOver:
+		m_round_over = true;
+		m_game_over = true;
+		m_game_over_timer = sf::Time::Zero;
+		break;
+	case RoundEvent::Type::kPickupCollected:
+		if (Aircraft* aircraft = GetPlayerAircraft(event.player))
+		{
+			aircraft->PlayLocalSound(m_command_queue, SoundEffect::kCollectPickup);
+		}
+		break;
+	default:
+		break;
+	}
+	UpdateScoreDisplay();
+}
+
+void World::RecordRoundEvent(RoundEvent::Type type, int player, PickupType pickup)
+{
+	if (!m_record_round_events)
+		return;
+
+	RoundEvent event;
+	event.type = type;
+	event.round = m_current_round;
+	event.player = static_cast<std::int8_t>(player);
+	event.pickup = pickup;
+	for (int i = 0; i < WorldSnapshot::kMaxPlayers; ++i)
+	{
+		event.scores[i] = GetPlayerScore(i);
+	}
+	m_round_events.push_back(event);
+}
+
+void World::ResetPredictedPlayer(int player_index, const WorldSnapshot& snapshot)
+{
+	Aircraft* aircraft = GetPlayerAircraft(player_index);
+	if (!aircraft)
+		return;
+
+	if (const EntitySnapshot* state = snapshot.FindEntity(aircraft->GetNetworkId()))
+	{
+		ApplyEntityState(*aircraft, *state);
+	}
+}
+
+void World::ApplyEntityState(Entity& entity, const EntitySnapshot& state)
+{
+	entity.setPosition(state.position);
+	entity.SetVelocity(state.velocity);
+	entity.SetHitPoints(state.hitpoints);
+
+	if (state.type == NetworkEntityType::kAircraft)
+	{
+		Aircraft& aircraft = static_cast<Aircraft&>(entity);
+		//The predicted player aims locally, the server's gun angle is only ever behind it
+		if (!aircraft.IsLocallyPredicted())
+		{
+			aircraft.SetGunRotation(state.gun_rotation);
+		}
+		aircraft.SetActivePowerUps(state.powerups);
+		aircraft.SetOnGround(state.on_ground);
+
+		//ApplyKnockback adds to the velocity, which already came from the server
+		aircraft.ClearKnockback();
+		if (state.knockback_seconds > 0.f)
+		{
+			aircraft.ApplyKnockback(state.velocity, sf::seconds(state.knockback_seconds));
+			aircraft.SetVelocity(state.velocity);
+		}
+	}
+}
+
+void World::SetPredictedPlayer(int player_index)
+{
+	for (std::size_t i = 0; i < m_player_aircrafts.size(); ++i)
+	{
+		if (m_player_aircrafts[i])
+		{
+			m_player_aircrafts[i]->SetLocallyPredicted(static_cast<int>(i) == player_index);
+		}
+	}
+}
+
+void World::PredictPlayer(int player_index, const Player& player, const PlayerInput& input, sf::Time dt)
+{
+	Aircraft* aircraft = GetPlayerAircraft(player_index);
+	//The server's World doesn't move anyone while a round is over either
+	if (!aircraft || aircraft->IsDestroyed() || m_round_over || m_game_over)
+		return;
+
+	//Same order as Update: forces, velocity adjustments, commands, scene update, bounds and collisions
+	if (aircraft->IsUsingPhysics())
+	{
+		aircraft->AddForce({ 0.f, m_gravity_acceleration * aircraft->GetMass() });
+	}
+	if (!aircraft->IsKnockbackActive())
+	{
+		aircraft->SetVelocity(0.f, aircraft->GetVelocity().y);
+	}
+	AdaptPlayerVelocity(*aircraft);
+
+	const unsigned int fire_bit = Player::GetActionBit(Action::kBulletFire);
+	player.ApplyActions(input.actions & ~fire_bit, *aircraft, dt);
+	SetPlayerAimDirection(player_index, input.aim);
+
+	const sf::Vector2f start_position = aircraft->getPosition();
+	aircraft->IntegrateMotion(dt);
+	AdaptPlayerPosition(*aircraft);
+	if (aircraft->IsKnockbackActive())
+	{
+		SweepPlayer(*aircraft, aircraft->getPosition() - start_position);
+	}
+
+	bool grounded = false;
+	const sf::FloatRect player_rect = aircraft->GetBoundingRect();
+	m_static_hits.clear();
+	m_static_geometry.Query(player_rect, static_cast<unsigned int>(ReceiverCategories::kPlatform), m_static_hits);
+	for (const StaticGeometry::Entry* platform : m_static_hits)
+	{
+		bool landed = false;
+		ResolvePlayerContact(*aircraft, platform->m_rect, 0.f, landed);
+		grounded = grounded || landed;
+	}
+
+	//Boxes are the server's to move, the player just takes its share of the separation, split by mass as the server does
+	CollectPredictionSolids();
+	for (SceneNode* solid : m_prediction_solids)
+	{
+		//Boxes the last snapshot removed stay in the graph until the next cleanup
+		auto& box = static_cast<Entity&>(*solid);
+		if (box.IsDestroyed())
+			continue;
+
+		const sf::FloatRect box_rect = box.GetBoundingRect();
+		if (!player_rect.findIntersection(box_rect))
+			continue;
+
+		const float player_mass = aircraft->GetMass();
+		const float box_share = player_mass / (player_mass + box.GetMass());
+
+		bool landed = false;
+		ResolvePlayerContact(*aircraft, box_rect, box_share, landed);
+		grounded = grounded || landed;
+	}
+	aircraft->SetOnGround(grounded);
+}
+
+void World::CollectPredictionSolids()
+{
+	if (!m_prediction_solids_dirty)
+		return;
+
+	m_prediction_solids.clear();
+	Command collect;
+	collect.category = static_cast<int>(ReceiverCategories::kBox);
+	collect.action = [this](SceneNode& node, sf::Time)
+		{
+			m_prediction_solids.push_back(&node);
+		};
+	m_scenegraph.OnCommand(collect, sf::Time::Zero);
+	m_prediction_solids_dirty = false;
+}
+
+void World::RegisterNetworkEntity(Entity& entity)
+{
+	entity.SetNetworkId(m_next_network_id++);
+}
+
+Entity* World::CreateReplica(const EntitySnapshot& snapshot)
+{
+	Entity* entity = nullptr;
+	switch (snapshot.type)
+	{
+	case NetworkEntityType::kProjectile:
+	{
+		if (snapshot.subtype >= static_cast<int>(ProjectileType::kProjectileCount))
+			return nullptr;
+
+		std::unique_ptr<Projectile> projectile(new Projectile(static_cast<ProjectileType>(snapshot.subtype), m_textures));
+		projectile->setRotation(sf::radians(std::atan2(snapshot.velocity.y, snapshot.velocity.x)));
+		entity = projectile.get();
+		m_scene_layers[static_cast<int>(SceneLayers::kLowerAir)]->AttachChild(std::move(projectile));
+		break;
+	}
+	case NetworkEntityType::kPickup:
+	{
+		if (snapshot.subtype >= static_cast<int>(PickupType::kPickupCount))
+			return nullptr;
+
+		std::unique_ptr<Pickup> pickup(new Pickup(static_cast<PickupType>(snapshot.subtype), m_textures));
+		entity = pickup.get();
+		m_scene_layers[static_cast<int>(SceneLayers::kUpperAir)]->AttachChild(std::move(pickup));
+		break;
+	}
+	case NetworkEntityType::kBox:
+		entity = AddBox(snapshot.position.x, snapshot.position.y);
+		break;
+	default:
+		//Aircraft are built with the scene on both ends and are never created mid match
+		return nullptr;
+	}
+
+	entity->SetNetworkId(snapshot.network_id);
+	entity->setPosition(snapshot.position);
+	//Nothing to blend from on the frame it appears
+	entity->ResetInterpolation();
+	return entity;
+}
+
+std::size_t World::CountEntities(ReceiverCategories category)
+{
+	std::size_t count = 0;
+	Command counter;
+	counter.category = static_cast<int>(category);
+	counter.action = [&count](SceneNode&, sf::Time)
+		{
+			++count;
+		};
+	m_scenegraph.OnCommand(counter, sf::Time::Zero);
+	return count;
+}
+
 CommandQueue& World::GetCommandQueue()
 {
 	return m_command_queue;
@@ -727,32 +1297,53 @@ void World::LoadTextures()
 void World::AddPlatform(float x, float y, float width, float height, float unit)
 {
 	sf::Vector2f platformSize(width * unit, height * unit);
-	sf::Texture& platformTexture = m_textures.Get(TextureID::kPlatform);
-	platformTexture.setRepeated(true);
-
-	std::unique_ptr<Platform> platform(new Platform(platformSize, platformTexture));
+	std::unique_ptr<Platform> platform;
+	if (m_textures.Contains(TextureID::kPlatform))
+	{
+		sf::Texture& platformTexture = m_textures.Get(TextureID::kPlatform);
+		platformTexture.setRepeated(true);
+		platform.reset(new Platform(platformSize, platformTexture));
+	}
+	else
+	{
+		platform.reset(new Platform(platformSize));
+	}
 
 	platform->setPosition(sf::Vector2f{x * unit, y * unit});
 
+	Platform* platform_node = platform.get();
 	m_scene_layers[static_cast<int>(SceneLayers::kUpperAir)]->AttachChild(std::move(platform));
+	m_static_geometry.Add(*platform_node, platform_node->GetBoundingRect(), platform_node->GetCategory());
 }
 
-void World::AddBox(float x, float y)
+Box* World::AddBox(float x, float y)
 {
 	const float tile_unit = 64.f;
 	sf::Vector2f boxSize(tile_unit, tile_unit);
-	sf::Texture& boxTexture = m_textures.Get(TextureID::kBox);
-
-	std::unique_ptr<Box> box(new Box(boxSize, boxTexture));
+	std::unique_ptr<Box> box;
+	if (m_textures.Contains(TextureID::kBox))
+	{
+		box.reset(new Box(boxSize, m_textures.Get(TextureID::kBox)));
+	}
+	else
+	{
+		box.reset(new Box(boxSize, sf::Color(160, 110, 60)));
+	}
 
 	// Convert top-left to center
 	box->setPosition(sf::Vector2f{x, y});
+	RegisterNetworkEntity(*box);
 
+	Box* box_node = box.get();
 	m_scene_layers[static_cast<int>(SceneLayers::kUpperAir)]->AttachChild(std::move(box));
+	return box_node;
 }
 
 void World::BuildScene()
 {
+	//Commands are routed through the root's category index instead of walking the whole graph
+	m_scenegraph.EnableCategoryIndex();
+
 	//Initialize the different layers
 	for (std::size_t i = 0; i < static_cast<int>(SceneLayers::kLayerCount); ++i)
 	{
@@ -763,24 +1354,27 @@ void World::BuildScene()
 	}
 
 	//Prepare the background
-	sf::Texture& texture = m_textures.Get(TextureID::kJungle);
-	texture.setRepeated(true);
-	const float zoomFactor = 1.35f;
-	const float extraCoverage = 1.5f;
-
-	sf::IntRect textureRect(
-		{ 0, 0 },
-		{ static_cast<int>(m_world_bounds.size.x * zoomFactor * extraCoverage),
-		  static_cast<int>(m_world_bounds.size.y * zoomFactor * extraCoverage) }
-	);
-
-	//Add the background sprite to the world
-	std::unique_ptr<SpriteNode> background_sprite(new SpriteNode(texture, textureRect));
-	background_sprite->setPosition({
-		m_world_bounds.position.x - (textureRect.size.x - m_world_bounds.size.x) / 2.f,
-		m_world_bounds.position.y - (textureRect.size.y - m_world_bounds.size.y) / 2.f
-		});
-	m_scene_layers[static_cast<int>(SceneLayers::kBackground)]->AttachChild(std::move(background_sprite));
+	if (!IsHeadless())
+	{
+		sf::Texture& texture = m_textures.Get(TextureID::kJungle);
+		texture.setRepeated(true);
+		const float zoomFactor = 1.35f;
+		const float extraCoverage = 1.5f;
+
+		sf::IntRect textureRect(
+			{ 0, 0 },
+			{ static_cast<int>(m_world_bounds.size.x * zoomFactor * extraCoverage),
+			  static_cast<int>(m_world_bounds.size.y * zoomFactor * extraCoverage) }
+		);
+
+		//Add the background sprite to the world
+		std::unique_ptr<SpriteNode> background_sprite(new SpriteNode(texture, textureRect));
+		background_sprite->setPosition({
+			m_world_bounds.position.x - (textureRect.size.x - m_world_bounds.size.x) / 2.f,
+			m_world_bounds.position.y - (textureRect.size.y - m_world_bounds.size.y) / 2.f
+			});
+		m_scene_layers[static_cast<int>(SceneLayers::kBackground)]->AttachChild(std::move(background_sprite));
+	}
 
 	const int kMaxPlayers = 2;
 
@@ -788,6 +1382,7 @@ void World::BuildScene()
 	{
 		AircraftType player_type = (i == 0) ? AircraftType::kEagle : AircraftType::kEaglePlayer2;
 		std::unique_ptr<Aircraft> player(new Aircraft(player_type, m_textures, m_fonts, i));
+		player->SeedRandom(m_random());
 		Aircraft* player_aircraft = player.get();
 
 		//Position players side by side
@@ -805,6 +1400,8 @@ void World::BuildScene()
 		}
 
 		player_aircraft->setPosition(spawn_position);
+		//Registered in build order, so a replica's players and boxes get the same ids as the server's
+		RegisterNetworkEntity(*player_aircraft);
 		m_scene_layers[static_cast<int>(SceneLayers::kUpperAir)]->AttachChild(std::move(player));
 
 		player_aircraft->SetGunOffset({ 50.f, -10.f });
@@ -833,6 +1430,7 @@ void World::BuildScene()
 	AddPlatform(10.5f, 9.f, 4.f, 1.f, tile_unit);
 	AddPlatform(4.f, 16.f, 5.f, 1.f, tile_unit);
 	AddPlatform(18.f, 16.f, 5.f, 1.f, tile_unit);
+	m_static_geometry.Build();
 
 	AddBox(350.f, 600.f);
 	AddBox(410.f, 600.f);
@@ -840,6 +1438,10 @@ void World::BuildScene()
 	AddBox(890.f, 600.f);
 	AddBox(1100.f, 600.f);
 
+	//Everything below only exists to be seen or heard
+	if (IsHeadless())
+		return;
+
 	//Add the particle nodes to the scene
 	std::unique_ptr<ParticleNode> smokeNode(new ParticleNode(ParticleType::kSmoke, m_textures));
 	m_scene_layers[static_cast<int>(SceneLayers::kLowerAir)]->AttachChild(std::move(smokeNode));
@@ -851,7 +1453,7 @@ void World::BuildScene()
 	m_scene_layers[static_cast<int>(SceneLayers::kLowerAir)]->AttachChild(std::move(dustNode));
 
 	// Add sound effect node
-	std::unique_ptr<SoundNode> soundNode(new SoundNode(m_sounds));
+	std::unique_ptr<SoundNode> soundNode(new SoundNode(*m_sounds));
 	m_scenegraph.AttachChild(std::move(soundNode));
 
 	const float score_text_size = 2.f;
@@ -899,6 +1501,15 @@ void World::UpdateScoreDisplay()
 }
 
 void World::AdaptPlayerPosition()
+{
+	for (Aircraft* player : m_player_aircrafts)
+	{
+		if (player)
+			AdaptPlayerPosition(*player);
+	}
+}
+
+void World::AdaptPlayerPosition(Aircraft& player)
 {
 	const float border_distance = 0.f;
 
@@ -907,48 +1518,42 @@ void World::AdaptPlayerPosition()
 	const float top_bound = m_camera_play_bounds.position.y + border_distance;
 	const float bottom_bound = m_camera_play_bounds.position.y + m_camera_play_bounds.size.y - border_distance;
 
-	for (Aircraft* player : m_player_aircrafts)
-	{
-		if (!player)
-			continue;
+	sf::Vector2f oldPos = player.getPosition();
+	sf::Vector2f position = oldPos;
 
-		sf::Vector2f oldPos = player->getPosition();
-		sf::Vector2f position = oldPos;
+	position.x = std::max(position.x, left_bound);
+	position.x = std::min(position.x, right_bound);
+	position.y = std::max(position.y, top_bound);
+	position.y = std::min(position.y, bottom_bound);
 
-		position.x = std::max(position.x, left_bound);
-		position.x = std::min(position.x, right_bound);
-		position.y = std::max(position.y, top_bound);
-		position.y = std::min(position.y, bottom_bound);
+	player.setPosition(position);
 
-		player->setPosition(position);
-
-		if (!player->IsKnockbackActive())
-		{
-			//Edge Detection
-			const float epsilon = 0.5f;
+	if (!player.IsKnockbackActive())
+	{
+		//Edge Detection
+		const float epsilon = 0.5f;
 
-			bool hit_left = std::abs(position.x - left_bound) < epsilon && oldPos.x < position.x;
-			bool hit_right = std::abs(position.x - right_bound) < epsilon && oldPos.x > position.x;
-			bool hit_top = std::abs(position.y - top_bound) < epsilon && oldPos.y < position.y;
-			bool hit_bottom = std::abs(position.y - bottom_bound) < epsilon && oldPos.y > position.y;
+		bool hit_left = std::abs(position.x - left_bound) < epsilon && oldPos.x < position.x;
+		bool hit_right = std::abs(position.x - right_bound) < epsilon && oldPos.x > position.x;
+		bool hit_top = std::abs(position.y - top_bound) < epsilon && oldPos.y < position.y;
+		bool hit_bottom = std::abs(position.y - bottom_bound) < epsilon && oldPos.y > position.y;
 
-			if (hit_left || hit_right || hit_top || hit_bottom)
-			{
-				const float k_knockback_speed_x = 2500.f;
-				const float k_knockback_speed_y = 2000.f;
-				const sf::Time kKnockbackDuration = sf::seconds(0.2f);
+		if (hit_left || hit_right || hit_top || hit_bottom)
+		{
+			const float k_knockback_speed_x = 2500.f;
+			const float k_knockback_speed_y = 2000.f;
+			const sf::Time kKnockbackDuration = sf::seconds(0.2f);
 
-				float velocity_x = 0.f;
-				float velocity_y = 0.f;
+			float velocity_x = 0.f;
+			float velocity_y = 0.f;
 
-				//Push in opposite direction to the edge hit
-				if (hit_left) velocity_x = +k_knockback_speed_x;
-				if (hit_right) velocity_x = -k_knockback_speed_x;
-				if (hit_top) velocity_y = +k_knockback_speed_y;
-				if (hit_bottom) velocity_y = -k_knockback_speed_y;
+			//Push in opposite direction to the edge hit
+			if (hit_left) velocity_x = +k_knockback_speed_x;
+			if (hit_right) velocity_x = -k_knockback_speed_x;
+			if (hit_top) velocity_y = +k_knockback_speed_y;
+			if (hit_bottom) velocity_y = -k_knockback_speed_y;
 
-				player->ApplyKnockback({ velocity_x, velocity_y }, kKnockbackDuration);
-			}
+			player.ApplyKnockback({ velocity_x, velocity_y }, kKnockbackDuration);
 		}
 	}
 }
@@ -957,16 +1562,19 @@ void World::AdaptPlayerVelocity()
 {
 	for (Aircraft* player : m_player_aircrafts)
 	{
-		if (!player)
-			continue;
+		if (player)
+			AdaptPlayerVelocity(*player);
+	}
+}
 
-		sf::Vector2f velocity = player->GetVelocity();
+void World::AdaptPlayerVelocity(Aircraft& player)
+{
+	sf::Vector2f velocity = player.GetVelocity();
 
-		//If they are moving diagonally divide by sqrt 2
-		if (player->IsOnGround() && velocity.x != 0.f && velocity.y != 0.f)
-		{
-			player->SetVelocity(velocity / std::sqrt(2.f));
-		}
+	//If they are moving diagonally divide by sqrt 2
+	if (player.IsOnGround() && velocity.x != 0.f && velocity.y != 0.f)
+	{
+		player.SetVelocity(velocity / std::sqrt(2.f));
 	}
 }
 
@@ -977,6 +1585,7 @@ void World::SpawnEnemies()
 	{
 		SpawnPoint spawn = m_enemy_spawn_points.back();
 		std::unique_ptr<Aircraft> enemy(new Aircraft(spawn.m_type, m_textures, m_fonts));
+		enemy->SeedRandom(m_random());
 		enemy->setPosition({ spawn.m_x, spawn.m_y });
 		enemy->setRotation(sf::degrees(180.f));
 		m_scene_layers[static_cast<int>(SceneLayers::kUpperAir)]->AttachChild(std::move(enemy));
@@ -1017,14 +1626,14 @@ void World::SpawnPickups()
 	//Increase padding variety for more spread
 	const float min_padding = 80.f;
 	const float max_padding = 200.f;
-	const float random_padding = min_padding + (static_cast<float>(std::rand()) / RAND_MAX) * (max_padding - min_padding);
+	const float random_padding = Utility::RandomFloat(min_padding, max_padding, m_random);
 
 	const float min_x = view_bounds.position.x + random_padding;
 	const float max_x = view_bounds.position.x + view_bounds.size.x - random_padding;
-	const float spawn_x = min_x + static_cast<float>(std::rand()) / RAND_MAX * (max_x - min_x);
+	const float spawn_x = Utility::RandomFloat(min_x, max_x, m_random);
 
 	//Random pickup type
-	int random_type = std::rand() % static_cast<int>(PickupType::kPickupCount);
+	int random_type = Utility::RandomInt(static_cast<int>(PickupType::kPickupCount), m_random);
 	PickupType type = static_cast<PickupType>(random_type);
 
 	std::unique_ptr<Pickup> pickup(new Pickup(type, m_textures));
@@ -1115,447 +1724,378 @@ void World::GuideMissiles()
 	m_active_enemies.clear();
 }
 
-bool MatchesCategories(SceneNode::Pair& colliders, ReceiverCategories type1, ReceiverCategories type2)
+void World::ResolvePlayerContact(Aircraft& player, const sf::FloatRect& solid_rect, float solid_share, bool& landed)
 {
-	unsigned int category1 = colliders.first->GetCategory();
-	unsigned int category2 = colliders.second->GetCategory();
+	sf::Vector2f normal;
+	float depth = 0.f;
+	if (!ContactSolver::FindContact(player.GetBoundingRect(), solid_rect, normal, depth))
+		return;
 
-	if (static_cast<int>(type1) & category1 && static_cast<int>(type2) & category2)
+	//Same outcome as the server's solver for a single contact, the player stops closing in and takes its share of the overlap
+	sf::Vector2f velocity = player.GetVelocity();
+	const float closing_speed = velocity.x * normal.x + velocity.y * normal.y;
+	if (closing_speed < 0.f)
 	{
-		return true;
-	}
-	else if (static_cast<int>(type1) & category2 && static_cast<int>(type2) & category1)
-	{ 
-		std::swap(colliders.first, colliders.second);
-		return true;
-	}
-	else
-	{
-		return false;
+		player.SetVelocity(velocity - normal * closing_speed);
+		if (normal.y < 0.f)
+		{
+			player.ClearForces();
+			landed = true;
+		}
 	}
+	player.move(normal * (depth * (1.f - solid_share)));
 }
 
-void World::HandleCollisions()
+const CollisionTable& World::GetCollisionTable()
 {
-	std::set<SceneNode::Pair> collision_pairs;
-	m_scenegraph.CheckSceneCollision(m_scenegraph, collision_pairs);
+	static const CollisionTable table = []()
+		{
+			CollisionTable responses;
+			RegisterCollisionResponses(responses);
+			return responses;
+		}();
+	return table;
+}
 
-	//Track grounded state per player
-	std::map<Aircraft*, bool> player_grounded_state;
-	for (Aircraft* player : m_player_aircrafts)
-	{
-		if (player)
-			player_grounded_state[player] = false;
-	}
+void World::RegisterCollisionResponses(CollisionTable& table)
+{
+	table.Register(ReceiverCategories::kPlayerAircraft, ReceiverCategories::kEnemyAircraft, &World::HandlePlayerEnemyCollision);
+	table.Register(ReceiverCategories::kPlayerAircraft, ReceiverCategories::kPickup, &World::HandlePickupCollision);
+	table.Register(ReceiverCategories::kProjectile, ReceiverCategories::kPlatform, &World::HandleProjectilePlatformCollision);
+	table.Register(ReceiverCategories::kPlayerAircraft, ReceiverCategories::kEnemyProjectile, &World::HandleEnemyFireCollision);
+	table.Register(ReceiverCategories::kEnemyAircraft, ReceiverCategories::kAlliedProjectile, &World::HandleEnemyFireCollision);
+	table.Register(ReceiverCategories::kProjectile, ReceiverCategories::kBox, &World::HandleProjectileBoxCollision);
+	//Players can damage themselves with their own projectiles
+	table.Register(ReceiverCategories::kPlayerAircraft, ReceiverCategories::kAlliedProjectile, &World::HandlePlayerProjectileCollision);
+	table.Register(ReceiverCategories::kPlayerAircraft, ReceiverCategories::kPlatform, &World::HandlePlayerPlatformCollision);
+	table.Register(ReceiverCategories::kPlayerAircraft, ReceiverCategories::kBox, &World::HandlePlayerBoxCollision);
+	table.Register(ReceiverCategories::kBox, ReceiverCategories::kPlatform, &World::HandleBoxPlatformCollision);
+	table.Register(ReceiverCategories::kBox, ReceiverCategories::kBox, &World::HandleBoxBoxCollision);
+	table.SetStatic(ReceiverCategories::kPlatform);
+}
 
-	for (SceneNode::Pair pair : collision_pairs)
+void World::HandleCollisions()
+{
+	//Bullets and knocked back players are traced along this tick's motion first, the overlap test only sees where they ended up
+	SweepProjectiles();
+	for (Aircraft* player : m_player_aircrafts)
 	{
-		if (MatchesCategories(pair, ReceiverCategories::kPlayerAircraft, ReceiverCategories::kEnemyAircraft))
-		{
-			auto& player = static_cast<Aircraft&>(*pair.first);
-			auto& enemy = static_cast<Aircraft&>(*pair.second);
-			//Collision response
-			player.Damage(enemy.GetHitPoints());
-			enemy.Destroy();
-		}
-
-		else if (MatchesCategories(pair, ReceiverCategories::kPlayerAircraft, ReceiverCategories::kPickup))
+		if (player && !player->IsDestroyed() && player->IsKnockbackActive())
 		{
-			auto& player = static_cast<Aircraft&>(*pair.first);
-			auto& pickup = static_cast<Pickup&>(*pair.second);
-			//Collision response
-			pickup.Apply(player);
-			pickup.Destroy();
-			player.PlayLocalSound(m_command_queue, SoundEffect::kCollectPickup);
+			SweepPlayer(*player, player->GetTickMotion());
 		}
-		else if (MatchesCategories(pair, ReceiverCategories::kPlayerAircraft, ReceiverCategories::kPickup))
-		{
-			auto& player = static_cast<Aircraft&>(*pair.first);
-			auto& pickup = static_cast<Pickup&>(*pair.second);
+	}
 
-			std::cout << "Player " << player.GetPlayerId() << " collected pickup type: "
-				<< static_cast<int>(pickup.GetPickupType()) << std::endl;
+	//Broadphase: only nodes with a collision response go into the grid and only overlapping pairs that have one come out
+	const CollisionTable& table = GetCollisionTable();
+	m_collision_grid.Clear();
+	m_scenegraph.CollectCollidables(m_collision_grid, table);
+	m_collision_pairs.clear();
+	m_collision_grid.FindPairs(m_collision_pairs);
+	m_collision_grid.FindStaticPairs(m_static_geometry, m_collision_pairs);
+
+	//Overlaps between players, boxes and platforms only add contacts here, they are resolved together afterwards
+	m_contact_solver.Clear();
+	m_landed_players.clear();
+	for (const SceneNode::Pair& pair : m_collision_pairs)
+	{
+		table.Dispatch(*this, *pair.first, *pair.second);
+	}
+	m_contact_solver.Solve();
+	ApplyContactEffects();
 
-			//Collision response
-			pickup.Apply(player);
-			pickup.Destroy();
-			player.PlayLocalSound(m_command_queue, pickup.GetCollectSound());
-		}
-		else if (MatchesCategories(pair, ReceiverCategories::kProjectile, ReceiverCategories::kPlatform))
-		{
-			auto& projectile = static_cast<Projectile&>(*pair.first);
-			projectile.Destroy();
-		}
-		else if (MatchesCategories(pair, ReceiverCategories::kPlayerAircraft, ReceiverCategories::kEnemyProjectile) || MatchesCategories(pair, ReceiverCategories::kEnemyAircraft, ReceiverCategories::kAlliedProjectile))
-		{
-			auto& aircraft = static_cast<Aircraft&>(*pair.first);
-			auto& projectile = static_cast<Projectile&>(*pair.second);
+	HandleLagCompensatedHits();
 
-			TriggerDamageEffect();
-			TriggerScreenShake(0.001f, 0.03f);
+	//Apply grounded state to each player individually
+	for (Aircraft* player : m_player_aircrafts)
+	{
+		if (player)
+			player->SetOnGround(std::find(m_landed_players.begin(), m_landed_players.end(), player) != m_landed_players.end());
+	}
+}
 
-			//Collision response
-			aircraft.Damage(projectile.GetDamage());
-			projectile.Destroy();
-		}
-		else if (MatchesCategories(pair, ReceiverCategories::kProjectile, ReceiverCategories::kBox))
+void World::SaveSweptPositions()
+{
+	Command save;
+	save.category = static_cast<int>(ReceiverCategories::kProjectile) | static_cast<int>(ReceiverCategories::kPlayerAircraft);
+	save.action = [](SceneNode& node, sf::Time)
 		{
-			auto& projectile = static_cast<Projectile&>(*pair.first);
-			auto& box = static_cast<Box&>(*pair.second);
-
-			const float k_projectile_knockback = 8000.f;
-			sf::Vector2f knockback_force = projectile.GetVelocity();
-			float length = std::sqrt(knockback_force.x * knockback_force.x + knockback_force.y * knockback_force.y);
-			if (length > 0.f)
-			{
-				knockback_force = (knockback_force / length) * k_projectile_knockback * box.GetMass();
-				box.AddForce(knockback_force);
-			}
+			node.SavePreviousPosition();
+		};
+	m_scenegraph.OnCommand(save, sf::Time::Zero);
+}
 
-			projectile.Destroy();
-		}
-		else if (MatchesCategories(pair, ReceiverCategories::kPlayerAircraft, ReceiverCategories::kProjectile))
+void World::SweepProjectiles()
+{
+	Command sweep;
+	sweep.category = static_cast<int>(ReceiverCategories::kProjectile);
+	sweep.action = DerivedAction<Projectile>([this](Projectile& projectile, sf::Time)
 		{
-			//Player can damage themselves with their own projectiles
-			auto& aircraft = static_cast<Aircraft&>(*pair.first);
-			auto& projectile = static_cast<Projectile&>(*pair.second);
-
-			TriggerDamageEffect();
-			TriggerScreenShake(0.001f, 0.03f);
+			if (projectile.IsDestroyed())
+				return;
 
-			//Collision response
-			aircraft.Damage(projectile.GetDamage());
+			const CollisionTable& table = GetCollisionTable();
+			const sf::Vector2f motion = projectile.GetTickMotion();
+			const sf::FloatRect rect = projectile.GetBoundingRect();
+			float time = 0.f;
+			sf::Vector2f normal;
+			const StaticGeometry::Entry* hit = m_static_geometry.Sweep({ rect.position - motion, rect.size }, motion, table.GetMask(projectile.GetCategory()), time, normal);
+			if (!hit)
+				return;
 
-			const float k_projectile_knockback_multiplier = 1.5f;
-			const sf::Time k_projectile_knockback_duration = sf::seconds(0.2f);
-			sf::Vector2f knockback_vel = projectile.GetVelocity() * k_projectile_knockback_multiplier;
-			aircraft.ApplyKnockback(knockback_vel, k_projectile_knockback_duration);
+			//Back to where it first touched, then the usual response runs as if the overlap test had caught it there
+			projectile.move(motion * (time - 1.f));
+			table.Dispatch(*this, projectile, *hit->m_node);
+		});
+	m_scenegraph.OnCommand(sweep, sf::Time::Zero);
+}
 
-			projectile.Destroy();
-		}
-		else if (MatchesCategories(pair, ReceiverCategories::kPlayerAircraft, ReceiverCategories::kPlatform))
-		{
-			auto& player = static_cast<Aircraft&>(*pair.first);
-			auto& platform = static_cast<Platform&>(*pair.second);
+void World::SweepPlayer(Aircraft& aircraft, sf::Vector2f motion)
+{
+	const sf::FloatRect rect = aircraft.GetBoundingRect();
+	float time = 0.f;
+	sf::Vector2f normal;
+	if (!m_static_geometry.Sweep({ rect.position - motion, rect.size }, motion, static_cast<unsigned int>(ReceiverCategories::kPlatform), time, normal))
+		return;
 
-			sf::FloatRect player_rect = player.GetBoundingRect();
-			sf::FloatRect platform_rect = platform.GetBoundingRect();
+	//Stop where it touched and slide the rest of the way along the surface
+	const sf::Vector2f remaining = motion * (1.f - time);
+	const sf::Vector2f slide = remaining - normal * (remaining.x * normal.x + remaining.y * normal.y);
+	aircraft.move(motion * (time - 1.f) + slide);
+}
 
-			//Centers
-			const sf::Vector2f player_center{
-				player_rect.position.x + player_rect.size.x * 0.5f,
-				player_rect.position.y + player_rect.size.y * 0.5f
-			};
-			const sf::Vector2f platformCenter{
-				platform_rect.position.x + platform_rect.size.x * 0.5f,
-				platform_rect.position.y + platform_rect.size.y * 0.5f
-			};
+void World::HandlePlayerEnemyCollision(SceneNode& player_node, SceneNode& enemy_node)
+{
+	auto& player = static_cast<Aircraft&>(player_node);
+	auto& enemy = static_cast<Aircraft&>(enemy_node);
+	//Collision response
+	player.Damage(enemy.GetHitPoints());
+	enemy.Destroy();
+}
 
-			//Half extents
-			const sf::Vector2f player_half{ player_rect.size.x * 0.5f, player_rect.size.y * 0.5f };
-			const sf::Vector2f platform_half{ platform_rect.size.x * 0.5f, platform_rect.size.y * 0.5f };
+void World::HandlePickupCollision(SceneNode& player_node, SceneNode& pickup_node)
+{
+	auto& player = static_cast<Aircraft&>(player_node);
+	auto& pickup = static_cast<Pickup&>(pickup_node);
+	//Collision response
+	pickup.Apply(player);
+	pickup.Destroy();
+	player.PlayLocalSound(m_command_queue, SoundEffect::kCollectPickup);
+	RecordRoundEvent(RoundEvent::Type::kPickupCollected, player.GetPlayerId(), pickup.GetPickupType());
+}
 
-			//Delta between centers
-			const float delta_x = player_center.x - platformCenter.x;
-			const float delta_y = player_center.y - platformCenter.y;
+void World::HandleProjectilePlatformCollision(SceneNode& projectile_node, SceneNode&)
+{
+	auto& projectile = static_cast<Projectile&>(projectile_node);
+	projectile.Destroy();
+}
 
-			const float overlap_x = (player_half.x + platform_half.x) - std::abs(delta_x);
-			const float overlap_y = (player_half.y + platform_half.y) - std::abs(delta_y);
+void World::HandleEnemyFireCollision(SceneNode& aircraft_node, SceneNode& projectile_node)
+{
+	auto& aircraft = static_cast<Aircraft&>(aircraft_node);
+	auto& projectile = static_cast<Projectile&>(projectile_node);
 
-			if (overlap_x <= 0.f || overlap_y <= 0.f)
-				continue;
+	TriggerDamageEffect();
+	TriggerScreenShake(0.001f, 0.03f);
 
-			if (overlap_x < overlap_y)
-			{
-				//Side collision: push horizontally away from platform center
-				const float push = (delta_x > 0.f) ? overlap_x : -overlap_x;
-				player.move({ push, 0.f });
-
-				//Stop horizontal movement so player does not keep penetrating
-				sf::Vector2f vel = player.GetVelocity();
-				vel.x = 0.f;
-				player.SetVelocity(vel);
-			}
-			else
-			{
-				//Vertical collision
-				//If player coming from above and moving downward
-				const sf::Vector2f vel = player.GetVelocity();
-				if (delta_y < 0.f && vel.y > 0.f)
-				{
-					//land on top of platform: position player's bottom at platform top
-					const float platformTop = platform_rect.position.y;
-					const float newplayer_centerY = platformTop - player_half.y;
-					const float worlddelta_y = newplayer_centerY - player.GetWorldPosition().y;
-					player.move({ 0.f, worlddelta_y });
-
-					//Stop downward motion and clear forces
-					sf::Vector2f input_vector = player.GetVelocity();
-					if (input_vector.y > 0.f) input_vector.y = 0.f;
-					player.SetVelocity(input_vector);
-					player.ClearForces();
-
-					player_grounded_state[&player] = true;
-				}
-				else
-				{
-					//Hit from below: push player downward
-					const float push = (delta_y > 0.f) ? overlap_y : -overlap_y;
-					player.move({ 0.f, push });
-
-					//If pushed up/down, stop vertical velocity
-					sf::Vector2f input_vector = player.GetVelocity();
-					input_vector.y = 0.f;
-					player.SetVelocity(input_vector);
-				}
-			}
-		}
-		else if (MatchesCategories(pair, ReceiverCategories::kPlayerAircraft, ReceiverCategories::kBox))
-		{
-			auto& player = static_cast<Aircraft&>(*pair.first);
-			auto& box = static_cast<Box&>(*pair.second);
+	//Collision response
+	aircraft.Damage(projectile.GetDamage());
+	projectile.Destroy();
+}
 
-			sf::FloatRect player_rect = player.GetBoundingRect();
-			sf::FloatRect box_rect = box.GetBoundingRect();
+void World::HandleProjectileBoxCollision(SceneNode& projectile_node, SceneNode& box_node)
+{
+	auto& projectile = static_cast<Projectile&>(projectile_node);
+	auto& box = static_cast<Box&>(box_node);
+	//A sleeping box is found a margin early, only an actual hit counts
+	if (box.IsAsleep() && !Collision(projectile, box))
+		return;
 
-			//Centers
-			const sf::Vector2f player_center{
-				player_rect.position.x + player_rect.size.x * 0.5f,
-				player_rect.position.y + player_rect.size.y * 0.5f
-			};
-			const sf::Vector2f box_center{
-				box_rect.position.x + box_rect.size.x * 0.5f,
-				box_rect.position.y + box_rect.size.y * 0.5f
-			};
+	const float k_projectile_knockback = 8000.f;
+	sf::Vector2f knockback_force = projectile.GetVelocity();
+	float length = std::sqrt(knockback_force.x * knockback_force.x + knockback_force.y * knockback_force.y);
+	if (length > 0.f)
+	{
+		knockback_force = (knockback_force / length) * k_projectile_knockback * box.GetMass();
+		box.AddForce(knockback_force);
+	}
 
-			//Half extents
-			const sf::Vector2f player_half{ player_rect.size.x * 0.5f, player_rect.size.y * 0.5f };
-			const sf::Vector2f box_half{ box_rect.size.x * 0.5f, box_rect.size.y * 0.5f };
+	projectile.Destroy();
+}
 
-			//Delta between centers
-			const float delta_x = player_center.x - box_center.x;
-			const float delta_y = player_center.y - box_center.y;
+void World::HandlePlayerProjectileCollision(SceneNode& player_node, SceneNode& projectile_node)
+{
+	auto& aircraft = static_cast<Aircraft&>(player_node);
+	auto& projectile = static_cast<Projectile&>(projectile_node);
 
-			const float overlap_x = (player_half.x + box_half.x) - std::abs(delta_x);
-			const float overlap_y = (player_half.y + box_half.y) - std::abs(delta_y);
+	//Shots from a lagging player are checked against the past in HandleLagCompensatedHits instead
+	if (IsLagCompensated(aircraft, projectile))
+		return;
 
-			if (overlap_x <= 0.f || overlap_y <= 0.f)
-				continue;
+	HitPlayerWithProjectile(aircraft, projectile);
+}
 
-			if (overlap_x < overlap_y)
-			{
-				//Side collision: push box horizontally
-				const float push = (delta_x > 0.f) ? overlap_x : -overlap_x;
-
-				//Push both player and box apart
-				player.move({ push * 0.5f, 0.f });
-				box.move({ -push * 0.5f, 0.f });
-
-				//Apply force to push the box
-				const float pushForce = 5000.f;
-				float forceDirection = (delta_x > 0.f) ? -1.f : 1.f;
-				box.AddForce({ forceDirection * pushForce * box.GetMass(), 0.f });
-
-				//Stop horizontal movement
-				sf::Vector2f vel = player.GetVelocity();
-				vel.x = 0.f;
-				player.SetVelocity(vel);
-			}
-			else
-			{
-				//Vertical collision
-				const sf::Vector2f vel = player.GetVelocity();
-				if (delta_y < 0.f && vel.y > 0.f)
-				{
-					//Player landing on top of box
-					const float boxTop = box_rect.position.y;
-					const float newplayer_centerY = boxTop - player_half.y;
-					const float worlddelta_y = newplayer_centerY - player.GetWorldPosition().y;
-					player.move({ 0.f, worlddelta_y });
-
-					//Stop downward motion and clear forces
-					sf::Vector2f input_vector = player.GetVelocity();
-					if (input_vector.y > 0.f) input_vector.y = 0.f;
-					player.SetVelocity(input_vector);
-					player.ClearForces();
-
-					player_grounded_state[&player] = true;
-				}
-				else
-				{
-					//Hit from below: push both apart
-					const float push = (delta_y > 0.f) ? overlap_y : -overlap_y;
-					player.move({ 0.f, push * 0.5f });
-					box.move({ 0.f, -push * 0.5f });
-
-					//Stop vertical velocity
-					sf::Vector2f input_vector = player.GetVelocity();
-					input_vector.y = 0.f;
-					player.SetVelocity(input_vector);
-				}
-			}
-		}
-		else if (MatchesCategories(pair, ReceiverCategories::kBox, ReceiverCategories::kPlatform))
-		{
-			auto& box = static_cast<Box&>(*pair.first);
-			auto& platform = static_cast<Platform&>(*pair.second);
+void World::HandlePlayerPlatformCollision(SceneNode& player, SceneNode& platform)
+{
+	static_cast<void>(m_contact_solver.AddContact(static_cast<Aircraft&>(player), platform.GetBoundingRect()));
+}
 
-			sf::FloatRect box_rect = box.GetBoundingRect();
-			sf::FloatRect platform_rect = platform.GetBoundingRect();
+void World::HandlePlayerBoxCollision(SceneNode& player_node, SceneNode& box_node)
+{
+	auto& player = static_cast<Aircraft&>(player_node);
+	auto& box = static_cast<Box&>(box_node);
+	//A player just standing next to a sleeping box leaves it be, walking into it wakes it
+	if (box.IsAsleep() && !Collision(player, box))
+		return;
 
-			//Centers
-			const sf::Vector2f box_center{
-				box_rect.position.x + box_rect.size.x * 0.5f,
-				box_rect.position.y + box_rect.size.y * 0.5f
-			};
-			const sf::Vector2f platform_center{
-				platform_rect.position.x + platform_rect.size.x * 0.5f,
-				platform_rect.position.y + platform_rect.size.y * 0.5f
-			};
+	box.WakeUp();
+	static_cast<void>(m_contact_solver.AddContact(player, box, 0.f));
+}
 
-			//Half extents
-			const sf::Vector2f box_half{ box_rect.size.x * 0.5f, box_rect.size.y * 0.5f };
-			const sf::Vector2f platform_half{ platform_rect.size.x * 0.5f, platform_rect.size.y * 0.5f };
+void World::HandleBoxPlatformCollision(SceneNode& box, SceneNode& platform)
+{
+	static_cast<void>(m_contact_solver.AddContact(static_cast<Box&>(box), platform.GetBoundingRect()));
+}
 
-			//Delta between centers
-			const float delta_x = box_center.x - platform_center.x;
-			const float delta_y = box_center.y - platform_center.y;
+void World::HandleBoxBoxCollision(SceneNode& first, SceneNode& second)
+{
+	auto& box1 = static_cast<Box&>(first);
+	auto& box2 = static_cast<Box&>(second);
 
-			const float overlap_x = (box_half.x + platform_half.x) - std::abs(delta_x);
-			const float overlap_y = (box_half.y + platform_half.y) - std::abs(delta_y);
+	if (box1.IsAsleep() && box2.IsAsleep())
+		return;
 
-			if (overlap_x <= 0.f || overlap_y <= 0.f)
-				continue;
+	//Only a neighbour that is actually moving wakes a sleeping box, touching is enough so a box is woken when its support moves away
+	//A neighbour that is settling as well rests on the sleeping box like on a platform, so the two don't keep waking each other
+	if (box1.IsAsleep() || box2.IsAsleep())
+	{
+		Box& sleeper = box1.IsAsleep() ? box1 : box2;
+		Box& neighbour = box1.IsAsleep() ? box2 : box1;
+		if (neighbour.IsAtRest())
+		{
+			static_cast<void>(m_contact_solver.AddContact(neighbour, sleeper.GetBoundingRect()));
+			return;
+		}
+		sleeper.WakeUp();
+	}
 
-			if (overlap_x < overlap_y)
-			{
-				//Side collision: push box horizontally
-				const float push = (delta_x > 0.f) ? overlap_x : -overlap_x;
-				box.move({ push, 0.f });
-
-				//Stop horizontal movement
-				sf::Vector2f vel = box.GetVelocity();
-				vel.x = 0.f;
-				box.SetVelocity(vel);
-			}
-			else
-			{
-				//Vertical collision
-				const sf::Vector2f vel = box.GetVelocity();
-				if (delta_y < 0.f && vel.y > 0.f)
-				{
-					//Box landing on platform
-					const float platformTop = platform_rect.position.y;
-					const float newbox_centerY = platformTop - box_half.y;
-					const float worlddelta_y = newbox_centerY - box.GetWorldPosition().y;
-					box.move({ 0.f, worlddelta_y });
-
-					//Stop downward motion and clear forces
-					sf::Vector2f input_vector = box.GetVelocity();
-					if (input_vector.y > 0.f) input_vector.y = 0.f;
-					box.SetVelocity(input_vector);
-					box.ClearForces();
-				}
-				else
-				{
-					//Hit from below: push box upward
-					const float push = (delta_y > 0.f) ? overlap_y : -overlap_y;
-					box.move({ 0.f, push });
+	const float bounciness = 0.5f;
+	static_cast<void>(m_contact_solver.AddContact(box1, box2, bounciness));
+}
 
-					sf::Vector2f input_vector = box.GetVelocity();
-					input_vector.y = 0.f;
-					box.SetVelocity(input_vector);
-				}
-			}
-		}
-		else if (MatchesCategories(pair, ReceiverCategories::kBox, ReceiverCategories::kBox))
+void World::ApplyContactEffects()
+{
+	for (const ContactSolver::Manifold& contact : m_contact_solver.GetManifolds())
+	{
+		//A player walking into a box shoves it along
+		if (contact.normal.x != 0.f && contact.second && (contact.second->GetCategory() & static_cast<unsigned int>(ReceiverCategories::kBox))
+			&& (contact.first->GetCategory() & static_cast<unsigned int>(ReceiverCategories::kPlayerAircraft)))
 		{
-			auto& box1 = static_cast<Box&>(*pair.first);
-			auto& box2 = static_cast<Box&>(*pair.second);
+			const float pushForce = 5000.f;
+			contact.second->AddForce({ -contact.normal.x * pushForce * contact.second->GetMass(), 0.f });
+			continue;
+		}
 
-			sf::FloatRect box1_rect = box1.GetBoundingRect();
-			sf::FloatRect box2_rect = box2.GetBoundingRect();
+		//Whatever came down on top of something has landed, it stops being pulled through it
+		if (contact.normal.y == 0.f || !contact.approaching)
+			continue;
+		Entity* top = contact.normal.y < 0.f ? contact.first : contact.second;
+		if (!top)
+			continue;
 
-			//Centers
-			const sf::Vector2f box1_center{
-				box1_rect.position.x + box1_rect.size.x * 0.5f,
-				box1_rect.position.y + box1_rect.size.y * 0.5f
-			};
-			const sf::Vector2f box2_center{
-				box2_rect.position.x + box2_rect.size.x * 0.5f,
-				box2_rect.position.y + box2_rect.size.y * 0.5f
-			};
+		top->ClearForces();
+		if (top->GetCategory() & static_cast<unsigned int>(ReceiverCategories::kPlayerAircraft))
+		{
+			m_landed_players.push_back(static_cast<Aircraft*>(top));
+		}
+	}
+}
 
-			//Half extents
-			const sf::Vector2f box1_half{ box1_rect.size.x * 0.5f, box1_rect.size.y * 0.5f };
-			const sf::Vector2f box2_half{ box2_rect.size.x * 0.5f, box2_rect.size.y * 0.5f };
+void World::HitPlayerWithProjectile(Aircraft& aircraft, Projectile& projectile)
+{
+	TriggerDamageEffect();
+	TriggerScreenShake(0.001f, 0.03f);
 
-			//Delta between centers
-			const float delta_x = box1_center.x - box2_center.x;
-			const float delta_y = box1_center.y - box2_center.y;
+	//Collision response
+	aircraft.Damage(projectile.GetDamage());
 
-			const float overlap_x = (box1_half.x + box2_half.x) - std::abs(delta_x);
-			const float overlap_y = (box1_half.y + box2_half.y) - std::abs(delta_y);
+	const float k_projectile_knockback_multiplier = 1.5f;
+	const sf::Time k_projectile_knockback_duration = sf::seconds(0.2f);
+	sf::Vector2f knockback_vel = projectile.GetVelocity() * k_projectile_knockback_multiplier;
+	aircraft.ApplyKnockback(knockback_vel, k_projectile_knockback_duration);
 
-			if (overlap_x <= 0.f || overlap_y <= 0.f)
-				continue;
+	projectile.Destroy();
+}
 
-			sf::Vector2f vel1 = box1.GetVelocity();
-			sf::Vector2f vel2 = box2.GetVelocity();
+void World::SetPlayerRewind(int player_index, int ticks)
+{
+	if (player_index < 0 || player_index >= static_cast<int>(m_player_rewind_ticks.size()))
+		return;
+	m_player_rewind_ticks[player_index] = std::clamp(ticks, 0, HitboxHistory::kCapacity - 1);
+}
 
-			const float mass1 = box1.GetMass();
-			const float mass2 = box2.GetMass();
-			const float total_mass = mass1 + mass2;
+bool World::IsLagCompensated(const Aircraft& aircraft, const Projectile& projectile) const
+{
+	//A player's own bullets hit their present self, they are the one who moved it
+	const int shooter = projectile.GetShooter();
+	return shooter >= 0 && shooter < static_cast<int>(m_player_rewind_ticks.size())
+		&& shooter != aircraft.GetPlayerId() && m_player_rewind_ticks[shooter] > 0;
+}
 
-			const float bounciness = 0.5f;
+void World::HandleLagCompensatedHits()
+{
+	bool any_rewind = false;
+	for (int ticks : m_player_rewind_ticks)
+	{
+		any_rewind = any_rewind || ticks > 0;
+	}
+	if (!any_rewind)
+		return;
 
-			if (overlap_x < overlap_y)
+	m_compensated_projectiles.clear();
+	Command collect;
+	collect.category = static_cast<int>(ReceiverCategories::kProjectile);
+	collect.action = DerivedAction<Projectile>([this](Projectile& projectile, sf::Time)
+		{
+			const int shooter = projectile.GetShooter();
+			if (!projectile.IsDestroyed() && shooter >= 0 && shooter < static_cast<int>(m_player_rewind_ticks.size())
+				&& m_player_rewind_ticks[shooter] > 0)
 			{
-				//Horizontal collision
-				const float push = (delta_x > 0.f) ? overlap_x : -overlap_x;
-
-				const float ratio1 = mass2 / total_mass;
-				const float ratio2 = mass1 / total_mass;
-
-				box1.move({ push * ratio1, 0.f });
-				box2.move({ -push * ratio2, 0.f });
-
-				const float relative_velocity = vel1.x - vel2.x;
-				const float impulse = (1.f + bounciness) * relative_velocity / total_mass;
-
-				vel1.x -= impulse * mass2;
-				vel2.x += impulse * mass1;
-
-				box1.SetVelocity(vel1);
-				box2.SetVelocity(vel2);
+				m_compensated_projectiles.push_back(&projectile);
 			}
-			else
-			{
-				//Vertical collision
-				const float push = (delta_y > 0.f) ? overlap_y : -overlap_y;
-
-				const float ratio1 = mass2 / total_mass;
-				const float ratio2 = mass1 / total_mass;
-
-				box1.move({ 0.f, push * ratio1 });
-				box2.move({ 0.f, -push * ratio2 });
+		});
+	m_scenegraph.OnCommand(collect, sf::Time::Zero);
 
-				const float relative_velocity = vel1.y - vel2.y;
-				const float impulse = (1.f + bounciness) * relative_velocity / total_mass;
+	for (Projectile* projectile : m_compensated_projectiles)
+	{
+		//The last recorded tick is the state the previous snapshot showed, rewind counts back from there
+		const std::uint32_t view_tick = m_simulation_tick - 1 - m_player_rewind_ticks[projectile->GetShooter()];
+		const sf::FloatRect projectile_rect = projectile->GetBoundingRect();
 
-				vel1.y -= impulse * mass2;
-				vel2.y += impulse * mass1;
+		for (Aircraft* aircraft : m_player_aircrafts)
+		{
+			if (!aircraft || aircraft->IsDestroyed() || !IsLagCompensated(*aircraft, *projectile))
+				continue;
 
-				box1.SetVelocity(vel1);
-				box2.SetVelocity(vel2);
+			const sf::FloatRect* past_rect = m_hitbox_history.Find(view_tick, aircraft->GetPlayerId());
+			const sf::FloatRect target_rect = past_rect ? *past_rect : aircraft->GetBoundingRect();
+			if (projectile_rect.findIntersection(target_rect))
+			{
+				HitPlayerWithProjectile(*aircraft, *projectile);
+				break;
 			}
 		}
 	}
+}
 
-	//Apply grounded state to each player individually
-	for (auto& pair : player_grounded_state)
+void World::RecordHitboxes()
+{
+	for (Aircraft* aircraft : m_player_aircrafts)
 	{
-		pair.first->SetOnGround(pair.second);
+		if (aircraft && !aircraft->IsDestroyed())
+		{
+			m_hitbox_history.Record(m_simulation_tick, aircraft->GetPlayerId(), aircraft->GetBoundingRect());
+		}
 	}
 }
 
@@ -1587,14 +2127,32 @@ void World::AimPlayerAtMouse(int player_index)
 	if (!player)
 		return;
 
-	if (auto* window = dynamic_cast<sf::RenderWindow*>(&m_target))
+	if (auto* window = dynamic_cast<sf::RenderWindow*>(m_target))
 	{
 		sf::Vector2i mouse_pixel = sf::Mouse::getPosition(*window);
-		sf::Vector2f mouse_world = m_target.mapPixelToCoords(mouse_pixel, m_camera);
+		sf::Vector2f mouse_world = window->mapPixelToCoords(mouse_pixel, m_camera);
 		player->AimGunAt(mouse_world);
 	}
 }
 
+sf::Vector2f World::GetAimDirectionToMouse(int player_index) const
+{
+	if (player_index < 0 || player_index >= static_cast<int>(m_player_aircrafts.size()))
+		return { 0.f, 0.f };
+
+	const Aircraft* player = m_player_aircrafts[player_index];
+	auto* window = dynamic_cast<sf::RenderWindow*>(m_target);
+	if (!player || !window)
+		return { 0.f, 0.f };
+
+	sf::Vector2f mouse_world = window->mapPixelToCoords(sf::Mouse::getPosition(*window), m_camera);
+	sf::Vector2f direction = mouse_world - player->GetWorldPosition();
+	float length = std::hypot(direction.x, direction.y);
+	if (length < 0.001f)
+		return { 0.f, 0.f };
+	return direction / length;
+}
+
 Aircraft* World::GetPlayerAircraft(int player_index)
 {
 	if (player_index >= 0 && player_index < static_cast<int>(m_player_aircrafts.size()))
@@ -1604,13 +2162,16 @@ Aircraft* World::GetPlayerAircraft(int player_index)
 
 void World::UpdateSounds()
 {
+	if (!m_sounds)
+		return;
+
 	// Set listener's position to first player's position (or could be average of all players)
 	if (!m_player_aircrafts.empty() && m_player_aircrafts[0])
 	{
-		m_sounds.SetListenerPosition(m_player_aircrafts[0]->GetWorldPosition());
+		m_sounds->SetListenerPosition(m_player_aircrafts[0]->GetWorldPosition());
 	}
 
 	// Remove unused sounds
-	m_sounds.RemoveStoppedSounds();
+	m_sounds->RemoveStoppedSounds();
 }
 	
\ No newline at end of file
@@ -13,15 +13,36 @@
 #include "ChromaticAberrationEffect.hpp"
 #include "ScreenShakeEffect.hpp"
 #include "PickupType.hpp"
+#include "ProjectileType.hpp"
+#include "FrameProfiler.hpp"
+#include "SpatialGrid.hpp"
+#include "StaticGeometry.hpp"
+#include "CollisionTable.hpp"
+#include "ContactSolver.hpp"
+#include "WorldSnapshot.hpp"
+#include "PlayerInput.hpp"
+#include "HitboxHistory.hpp"
+#include "RoundEvent.hpp"
 
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+class Box;
+class Player;
+class Projectile;
 
 class World 
 {
 public:
 	explicit World(sf::RenderTarget& target, FontHolder& font, SoundPlayer& sounds);
+	//Headless simulation: no render target, textures, shaders, fonts or sounds
+	World();
 	void Update(sf::Time dt);
-	void Draw();
+	//alpha is how far the render time has got from the previous tick towards the latest one
+	void Draw(float alpha = 1.f);
 
 	CommandQueue& GetCommandQueue();
 
@@ -30,6 +51,8 @@ public:
 
 	void SetPlayerAimDirection(int player_index, const sf::Vector2f& direction);
 	void AimPlayerAtMouse(int player_index);
+	//Unit direction from the player to the mouse cursor, zero without a window
+	sf::Vector2f GetAimDirectionToMouse(int player_index) const;
 
 	Aircraft* GetPlayerAircraft(int player_index);
 
@@ -39,15 +62,57 @@ public:
 	bool IsGameOver() const;
 	int GetWinner() const;
 	bool ShouldReturnToMenu() const;
+	bool IsHeadless() const;
 
 	void TriggerDamageEffect();
 	void TriggerScreenShake(float intensity, float duration);
 
+	//Optional per phase timing of Update and Draw, pass nullptr to disable
+	void SetProfiler(FrameProfiler* profiler);
+	//Seeds pickup spawns and everything the aircraft pick at random, worlds are seeded from the clock otherwise
+	void SetRandomSeed(unsigned int seed);
+
+	//Scenario hooks for the benchmark and headless runs
+	void SpawnProjectile(ProjectileType type, sf::Vector2f position, sf::Vector2f velocity);
+	void SpawnBox(sf::Vector2f position);
+	std::size_t CountEntities(ReceiverCategories category);
+	//Every World shares one table of collision responses, filled on first use
+	static const CollisionTable& GetCollisionTable();
+
+	//Networking: the server captures snapshots of its World, clients mirror them into a replica World
+	//A replica runs no gameplay rules of its own, entities only move between snapshots and rounds follow the server
+	void SetReplica(bool replica);
+	bool IsReplica() const;
+	void CaptureSnapshot(WorldSnapshot& snapshot);
+	void ApplySnapshot(const WorldSnapshot& snapshot);
+	//Round results, score changes and collected pickups go out as RoundEvents on the reliable channel instead of in snapshots
+	//The server records them once enabled and takes them every tick, CaptureRoundState describes the match so far for a client joining late
+	void SetRecordRoundEvents(bool record);
+	void TakeRoundEvents(std::vector<RoundEvent>& events);
+	RoundEvent CaptureRoundState() const;
+	void ApplyRoundEvent(const RoundEvent& event);
+
+	//Client side prediction: the predicted aircraft is left alone by ApplySnapshot and the replica's scene update, PredictPlayer moves it
+	//ResetPredictedPlayer puts it back to the server's newest state, the client then replays its unacknowledged input on top
+	void SetPredictedPlayer(int player_index);
+	void ResetPredictedPlayer(int player_index, const WorldSnapshot& snapshot);
+	//One tick of the server's movement rules for a single aircraft: gravity, the bound actions, integration, arena bounds and platform/box contacts
+	//Firing is left to the server, bullets only exist once a snapshot brings them
+	void PredictPlayer(int player_index, const Player& player, const PlayerInput& input, sf::Time dt);
+
+	//Lag compensation: this player's bullets are checked against where the other players were this many ticks ago
+	//0 checks against the present, the server sets it from how far behind each client is drawing the match
+	void SetPlayerRewind(int player_index, int ticks);
+
 private:
+	World(sf::RenderTarget* target, FontHolder* font, SoundPlayer* sounds);
+
 	void LoadTextures();
 	void BuildScene();
 	void AdaptPlayerPosition();
+	void AdaptPlayerPosition(Aircraft& player);
 	void AdaptPlayerVelocity();
+	void AdaptPlayerVelocity(Aircraft& player);
 
 	void SpawnEnemies();
 	void AddEnemies();
@@ -56,17 +121,48 @@ private:
 	void SpawnPickups();
 
 	sf::FloatRect GetViewBounds() const;
+	sf::View GetInterpolatedCamera(float alpha) const;
 	sf::FloatRect GetBattleFieldBounds() const;
 
 	void DestroyEntitiesOutsideView();
 	void GuideMissiles();
 
 	void HandleCollisions();
+	//Continuous collision against platforms, for bodies that can cover more than a platform's thickness in one tick
+	void SaveSweptPositions();
+	void SweepProjectiles();
+	void SweepPlayer(Aircraft& aircraft, sf::Vector2f motion);
+	static void RegisterCollisionResponses(CollisionTable& table);
+	void HandlePlayerEnemyCollision(SceneNode& player, SceneNode& enemy);
+	void HandlePickupCollision(SceneNode& player, SceneNode& pickup);
+	void HandleProjectilePlatformCollision(SceneNode& projectile, SceneNode& platform);
+	void HandleEnemyFireCollision(SceneNode& aircraft, SceneNode& projectile);
+	void HandleProjectileBoxCollision(SceneNode& projectile, SceneNode& box);
+	void HandlePlayerProjectileCollision(SceneNode& player, SceneNode& projectile);
+	void HandlePlayerPlatformCollision(SceneNode& player, SceneNode& platform);
+	void HandlePlayerBoxCollision(SceneNode& player, SceneNode& box);
+	void HandleBoxPlatformCollision(SceneNode& box, SceneNode& platform);
+	void HandleBoxBoxCollision(SceneNode& first, SceneNode& second);
+	void ApplyContactEffects();
+	//Separates a player from a platform or box along the axis of least overlap, solid_share of the separation goes to the solid
+	//landed is set when the player ends up standing on top of it
+	void ResolvePlayerContact(Aircraft& player, const sf::FloatRect& solid_rect, float solid_share, bool& landed);
+	void CollectPredictionSolids();
+	void HitPlayerWithProjectile(Aircraft& aircraft, Projectile& projectile);
+	bool IsLagCompensated(const Aircraft& aircraft, const Projectile& projectile) const;
+	void HandleLagCompensatedHits();
+	void RecordHitboxes();
 	void UpdateSounds();
 	void AddPlatform(float x, float y, float width, float height, float unit);
-	void AddBox(float x, float y);
+	Box* AddBox(float x, float y);
+
+	void UpdateReplica(sf::Time dt);
+	void RegisterNetworkEntity(Entity& entity);
+	Entity* CreateReplica(const EntitySnapshot& snapshot);
+	void ApplyEntityState(Entity& entity, const EntitySnapshot& state);
 
 	void CheckRoundEnd();
+	void RecordRoundEvent(RoundEvent::Type type, int player, PickupType pickup = PickupType::kHealthRefill);
 	void StartNewRound();
 	void RespawnPlayers();
 	int CountAlivePlayers() const;
@@ -100,12 +196,15 @@ private:
 	};
 
 private:
-	sf::RenderTarget& m_target;
-	sf::RenderTexture m_scene_texture;
+	sf::RenderTarget* m_target;
+	std::optional<sf::RenderTexture> m_scene_texture;
+	sf::View m_default_view;
 	sf::View m_camera;
+	sf::View m_previous_camera;
 	TextureHolder m_textures;
+	FontHolder m_headless_fonts;
 	FontHolder& m_fonts;
-	SoundPlayer& m_sounds;
+	SoundPlayer* m_sounds;
 	SceneNode m_scenegraph;
 	std::array<SceneNode*, static_cast<int>(SceneLayers::kLayerCount)> m_scene_layers;
 	sf::FloatRect m_world_bounds;
@@ -123,14 +222,14 @@ private:
 	sf::Time m_pickup_spawn_timer;
 	sf::Time m_pickup_spawn_interval;
 
-	BloomEffect m_bloom_effect;
-	ChromaticAberrationEffect m_chromatic_effect;
+	std::unique_ptr<BloomEffect> m_bloom_effect;
+	std::unique_ptr<ChromaticAberrationEffect> m_chromatic_effect;
 	float m_damage_effect_intensity;
 	sf::Time m_damage_effect_timer;
 	const float m_max_damage_intensity = 0.015f;
 	const sf::Time m_damage_effect_duration = sf::seconds(0.5f);
 
-	ScreenShakeEffect m_screen_shake_effect;
+	std::unique_ptr<ScreenShakeEffect> m_screen_shake_effect;
 	float m_screen_shake_intensity;
 	sf::Time m_screen_shake_timer;
 	sf::Time m_screen_shake_duration;
@@ -160,7 +259,38 @@ private:
 	const float m_zoom_speed = 0.5f;
 	const float m_min_player_distance = 400.f;
 	const float m_max_player_distance = 900.f;
+	const float m_gravity_acceleration = 200.f * 9.81f;
 
 	sf::FloatRect m_camera_play_bounds;
+
+	FrameProfiler* m_profiler;
+
+	SpatialGrid m_collision_grid;
+	//Platforms, filled in by AddPlatform and built at the end of BuildScene
+	StaticGeometry m_static_geometry;
+	std::vector<const StaticGeometry::Entry*> m_static_hits;
+	std::vector<SceneNode::Pair> m_collision_pairs;
+	//Players that ended up standing on something during this tick's collision responses
+	std::vector<Aircraft*> m_landed_players;
+	ContactSolver m_contact_solver;
+
+	bool m_is_replica;
+	std::uint32_t m_next_network_id;
+	std::unordered_map<std::uint32_t, Entity*> m_network_entities;
+
+	//Boxes the predicted player collides with, gathered again whenever the scene may have changed
+	std::vector<SceneNode*> m_prediction_solids;
+	bool m_prediction_solids_dirty;
+
+	//Counts every Update, hitboxes are recorded against it at the end of each simulated tick
+	std::uint32_t m_simulation_tick;
+	HitboxHistory m_hitbox_history;
+	std::array<int, WorldSnapshot::kMaxPlayers> m_player_rewind_ticks;
+	std::vector<Projectile*> m_compensated_projectiles;
+
+	bool m_record_round_events;
+	std::vector<RoundEvent> m_round_events;
+
+	std::default_random_engine m_random;
 };
 
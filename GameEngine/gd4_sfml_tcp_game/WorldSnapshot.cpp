@@ -0,0 +1,32 @@
+#include "WorldSnapshot.hpp"
+#include <algorithm>
+
+EntitySnapshot::EntitySnapshot()
+	: network_id(0)
+	, type(NetworkEntityType::kAircraft)
+	, subtype(0)
+	, position(0.f, 0.f)
+	, velocity(0.f, 0.f)
+	, gun_rotation(0.f)
+	, hitpoints(0)
+	, powerups(0)
+	, on_ground(false)
+	, knockback_seconds(0.f)
+{
+}
+
+WorldSnapshot::WorldSnapshot()
+	: tick(0)
+{
+}
+
+const EntitySnapshot* WorldSnapshot::FindEntity(std::uint32_t network_id) const
+{
+	auto found = std::lower_bound(entities.begin(), entities.end(), network_id, [](const EntitySnapshot& entity, std::uint32_t id)
+		{
+			return entity.network_id < id;
+		});
+	if (found != entities.end() && found->network_id == network_id)
+		return &*found;
+	return nullptr;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "NetworkEntityType.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+
+//State of one networked Entity, subtype is the ProjectileType, PickupType or player id depending on type
+//gun_rotation, powerups (bit per PickupType), on_ground and knockback_seconds are only used by aircraft
+struct EntitySnapshot
+{
+	EntitySnapshot();
+	std::uint32_t network_id;
+	NetworkEntityType type;
+	std::uint8_t subtype;
+	sf::Vector2f position;
+	sf::Vector2f velocity;
+	float gun_rotation;
+	std::int32_t hitpoints;
+	std::uint8_t powerups;
+	//Movement state the owning client needs to replay its unacknowledged input from this snapshot
+	bool on_ground;
+	float knockback_seconds;
+};
+
+//Every networked entity a replica World mirrors for one tick, round results arrive separately as RoundEvents
+struct WorldSnapshot
+{
+	static const int kMaxPlayers = 2;
+
+	WorldSnapshot();
+	//entities is sorted by network id, which SnapshotCodec relies on
+	const EntitySnapshot* FindEntity(std::uint32_t network_id) const;
+
+	std::uint32_t tick;
+	std::vector<EntitySnapshot> entities;
+};